@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    BiquadDesign.h
+    Closed-form biquad designs, written straight into caller-owned coefficients.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Normalised biquad coefficients (a0 == 1), in the order juce::dsp::IIR::Coefficients stores them.
+// This is plain data, so it can be designed and copied on the audio thread without touching the heap.
+struct BiquadCoefficients
+{
+    float b0 {1.0f}, b1 {0.0f}, b2 {0.0f}, a1 {0.0f}, a2 {0.0f};
+};
+
+// ------------------------------------------------------------------------------------
+// Every design below is computed in double and only rounded to float at the end, does not
+// allocate and has no virtual call: a redesign is a couple of trigonometric calls and a few
+// multiplications. The formulas are the bilinear transform designs JUCE uses (RBJ cookbook).
+// ------------------------------------------------------------------------------------
+
+// 1/Q of each 12db section of a Butterworth filter made of numSections sections:
+// 2 * cos((2i + 1) * pi / (4 * numSections)). Row numSections - 1, first numSections values.
+constexpr double butterworthInverseQ[4][4]
+{
+    { 1.4142135623730951 },
+    { 1.8477590650225735, 0.76536686473017967 },
+    { 1.9318516525781366, 1.4142135623730951, 0.51763809020504148 },
+    { 1.9615705608064609, 1.6629392246050905, 1.1111404660392046, 0.39018064403225666 }
+};
+
+// Second order low pass, from its prewarped cutoff n = 1 / tan(pi * f / fs)
+inline void designLowPass(BiquadCoefficients& c, double n, double inverseQ) noexcept
+{
+    const auto nSquared = n * n;
+    const auto c1 = 1.0 / (1.0 + inverseQ * n + nSquared);
+    
+    c.b0 = static_cast<float>(c1);
+    c.b1 = static_cast<float>(c1 * 2.0);
+    c.b2 = c.b0;
+    c.a1 = static_cast<float>(c1 * 2.0 * (1.0 - nSquared));
+    c.a2 = static_cast<float>(c1 * (1.0 - inverseQ * n + nSquared));
+}
+
+// Second order high pass, from its prewarped cutoff n = tan(pi * f / fs)
+inline void designHighPass(BiquadCoefficients& c, double n, double inverseQ) noexcept
+{
+    const auto nSquared = n * n;
+    const auto c1 = 1.0 / (1.0 + inverseQ * n + nSquared);
+    
+    c.b0 = static_cast<float>(c1);
+    c.b1 = static_cast<float>(c1 * -2.0);
+    c.b2 = c.b0;
+    c.a1 = static_cast<float>(c1 * 2.0 * (nSquared - 1.0));
+    c.a2 = static_cast<float>(c1 * (1.0 - inverseQ * n + nSquared));
+}
+
+// Butterworth low pass of order 2 * numSections (1 to 4), one biquad per section
+inline void designButterworthLowPass(BiquadCoefficients* sections, int numSections, double sampleRate, double frequency) noexcept
+{
+    jassert(numSections >= 1 && numSections <= 4);
+    
+    // Every section shares the same prewarped cutoff: a single tan for the whole cascade
+    const auto n = 1.0 / std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    
+    for (int i = 0; i < numSections; ++i)
+        designLowPass(sections[i], n, butterworthInverseQ[numSections - 1][i]);
+}
+
+// Butterworth high pass of order 2 * numSections (1 to 4), one biquad per section
+inline void designButterworthHighPass(BiquadCoefficients* sections, int numSections, double sampleRate, double frequency) noexcept
+{
+    jassert(numSections >= 1 && numSections <= 4);
+    
+    const auto n = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    
+    for (int i = 0; i < numSections; ++i)
+        designHighPass(sections[i], n, butterworthInverseQ[numSections - 1][i]);
+}
+
+// Peak (bell) filter, gain as a linear factor
+inline void designPeak(BiquadCoefficients& c, double sampleRate, double frequency, double Q, double gainFactor) noexcept
+{
+    const auto A = std::sqrt(juce::jmax(gainFactor, 1.0e-6));
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    const auto alpha = std::sin(omega) / (Q * 2.0);
+    const auto c2 = -2.0 * std::cos(omega);
+    const auto a0Inverse = 1.0 / (1.0 + alpha / A);
+    
+    c.b0 = static_cast<float>((1.0 + alpha * A) * a0Inverse);
+    c.b1 = static_cast<float>(c2 * a0Inverse);
+    c.b2 = static_cast<float>((1.0 - alpha * A) * a0Inverse);
+    c.a1 = c.b1;
+    c.a2 = static_cast<float>((1.0 - alpha / A) * a0Inverse);
+}
+
+// Low shelf, gain as a linear factor. Q sets the steepness of the transition.
+inline void designLowShelf(BiquadCoefficients& c, double sampleRate, double frequency, double Q, double gainFactor) noexcept
+{
+    const auto A = std::sqrt(juce::jmax(gainFactor, 1.0e-6));
+    const auto aMinus1 = A - 1.0;
+    const auto aPlus1 = A + 1.0;
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    const auto cosOmega = std::cos(omega);
+    const auto beta = std::sin(omega) * std::sqrt(A) / Q;
+    const auto aMinus1TimesCos = aMinus1 * cosOmega;
+    const auto a0Inverse = 1.0 / (aPlus1 + aMinus1TimesCos + beta);
+    
+    c.b0 = static_cast<float>(A * (aPlus1 - aMinus1TimesCos + beta) * a0Inverse);
+    c.b1 = static_cast<float>(A * 2.0 * (aMinus1 - aPlus1 * cosOmega) * a0Inverse);
+    c.b2 = static_cast<float>(A * (aPlus1 - aMinus1TimesCos - beta) * a0Inverse);
+    c.a1 = static_cast<float>(-2.0 * (aMinus1 + aPlus1 * cosOmega) * a0Inverse);
+    c.a2 = static_cast<float>((aPlus1 + aMinus1TimesCos - beta) * a0Inverse);
+}
+
+// High shelf, gain as a linear factor. Q sets the steepness of the transition.
+inline void designHighShelf(BiquadCoefficients& c, double sampleRate, double frequency, double Q, double gainFactor) noexcept
+{
+    const auto A = std::sqrt(juce::jmax(gainFactor, 1.0e-6));
+    const auto aMinus1 = A - 1.0;
+    const auto aPlus1 = A + 1.0;
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    const auto cosOmega = std::cos(omega);
+    const auto beta = std::sin(omega) * std::sqrt(A) / Q;
+    const auto aMinus1TimesCos = aMinus1 * cosOmega;
+    const auto a0Inverse = 1.0 / (aPlus1 - aMinus1TimesCos + beta);
+    
+    c.b0 = static_cast<float>(A * (aPlus1 + aMinus1TimesCos + beta) * a0Inverse);
+    c.b1 = static_cast<float>(A * -2.0 * (aMinus1 + aPlus1 * cosOmega) * a0Inverse);
+    c.b2 = static_cast<float>(A * (aPlus1 + aMinus1TimesCos - beta) * a0Inverse);
+    c.a1 = static_cast<float>(2.0 * (aMinus1 - aPlus1 * cosOmega) * a0Inverse);
+    c.a2 = static_cast<float>((aPlus1 - aMinus1TimesCos - beta) * a0Inverse);
+}
+
+// Notch: full rejection at the frequency, Q sets its width
+inline void designNotch(BiquadCoefficients& c, double sampleRate, double frequency, double Q) noexcept
+{
+    const auto n = 1.0 / std::tan(juce::MathConstants<double>::pi * juce::jmax(frequency, 2.0) / sampleRate);
+    const auto nSquared = n * n;
+    const auto inverseQ = 1.0 / Q;
+    const auto c1 = 1.0 / (1.0 + inverseQ * n + nSquared);
+    
+    c.b0 = static_cast<float>(c1 * (1.0 + nSquared));
+    c.b1 = static_cast<float>(2.0 * c1 * (1.0 - nSquared));
+    c.b2 = c.b0;
+    c.a1 = c.b1;
+    c.a2 = static_cast<float>(c1 * (1.0 - inverseQ * n + nSquared));
+}
+
+// Magnitude (linear gain) of a biquad at a given frequency, same maths as
+// juce::dsp::IIR::Coefficients::getMagnitudeForFrequency
+inline double getMagnitudeForFrequency(const BiquadCoefficients& c, double frequency, double sampleRate) noexcept
+{
+    const auto omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    const std::complex<double> z1 = std::polar(1.0, -omega);
+    const auto z2 = z1 * z1;
+    
+    const auto numerator   = (double) c.b0 + (double) c.b1 * z1 + (double) c.b2 * z2;
+    const auto denominator = 1.0 + (double) c.a1 * z1 + (double) c.a2 * z2;
+    
+    return std::abs(numerator / denominator);
+}
+
+// Number of samples the impulse response of a biquad takes to decay by decayInDecibels (e.g. -120db).
+// The slowest pole sets the pace: its radius r shrinks the response by r every sample.
+inline double getDecayLengthInSamples(const BiquadCoefficients& c, double decayInDecibels) noexcept
+{
+    // The poles are the roots of z^2 + a1.z + a2
+    const auto a1 = (double) c.a1;
+    const auto a2 = (double) c.a2;
+    const auto discriminant = a1 * a1 - 4.0 * a2;
+    
+    double radius;
+    
+    if (discriminant < 0.0)
+    {
+        // Complex pair: |p|^2 = a2
+        radius = std::sqrt(a2);
+    }
+    else
+    {
+        const auto root = std::sqrt(discriminant);
+        radius = juce::jmax(std::abs(-a1 + root), std::abs(-a1 - root)) * 0.5;
+    }
+    
+    // Feedforward part only lasts 3 samples
+    if (radius < 1.0e-9)
+        return 3.0;
+    
+    jassert(radius < 1.0); // Unstable design
+    radius = juce::jmin(radius, 0.999999);
+    
+    return 3.0 + std::ceil(decayInDecibels / (20.0 * std::log10(radius)));
+}
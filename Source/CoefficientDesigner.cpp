@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+    CoefficientDesigner.cpp
+    Designs the filter coefficients away from the audio thread.
+
+  ==============================================================================
+*/
+
+#include "CoefficientDesigner.h"
+#include "Tracer.h"
+
+//==============================================================================
+CoefficientDesigner::DesignThread::DesignThread() : juce::TimeSliceThread("SimplyQueue coefficient design")
+{
+    startThread();
+}
+
+CoefficientDesigner::DesignThread::~DesignThread()
+{
+    stopThread(1000);
+}
+
+//==============================================================================
+CoefficientDesigner::CoefficientDesigner(juce::AudioProcessorValueTreeState& state) : apvts(state), parameterValues(state)
+{
+    // Listening to the parameters only to wake the background thread early: it polls them anyway
+    for (auto* parameter : apvts.processor.getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            apvts.addParameterListener(ranged->getParameterID(), this);
+}
+
+CoefficientDesigner::~CoefficientDesigner()
+{
+    release();
+    
+    for (auto* parameter : apvts.processor.getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            apvts.removeParameterListener(ranged->getParameterID(), this);
+}
+
+void CoefficientDesigner::prepare(double newSampleRate)
+{
+    // Make sure the background thread is not designing while we change the sample rate,
+    // removing the client waits for its current time slice to finish
+    release();
+    
+    // Only designs the table if no other instance already runs at this sample rate
+    if (cutFilterTable == nullptr || cutFilterTable->getSampleRate() != newSampleRate)
+        cutFilterTable = cutFilterTableCache->getTable(newSampleRate);
+    
+    sampleRate = newSampleRate;
+    
+    // Synchronous first design: the audio thread has coefficients from the very first block.
+    // It covers a full update asked for before (e.g. by a state load): the thread must not
+    // publish the same design again under a new number.
+    forceFullUpdate = false;
+    designAndPublish(true);
+    
+    // The listener gets it straight away too, the thread is not running yet
+    if (listener != nullptr)
+        listener->designAvailable(publishedCoefficients, designNumber, sampleRate);
+    
+    designThread->addTimeSliceClient(this);
+    isRunning = true;
+}
+
+void CoefficientDesigner::release()
+{
+    if (isRunning)
+    {
+        designThread->removeTimeSliceClient(this);
+        isRunning = false;
+    }
+}
+
+void CoefficientDesigner::triggerFullUpdate() noexcept
+{
+    forceFullUpdate = true;
+    parametersChanged = true;
+}
+
+void CoefficientDesigner::setNeutralBandThreshold(float decibels) noexcept
+{
+    neutralBandThreshold = juce::jmax(0.0f, decibels);
+    
+    // Every band has to be checked again against the new threshold
+    triggerFullUpdate();
+}
+
+void CoefficientDesigner::setPublishNotifier(juce::AsyncUpdater* notifier) noexcept
+{
+    const juce::SpinLock::ScopedLockType lock(notifierLock);
+    publishNotifier = notifier;
+}
+
+int CoefficientDesigner::useTimeSlice()
+{
+    const auto forceUpdate = forceFullUpdate.exchange(false);
+    parametersChanged = false;
+    
+    // Comparing the settings catches every change, the listener flag only makes us come back sooner
+    const auto designed = designAndPublish(forceUpdate);
+    
+    if (listener != nullptr)
+        listener->designAvailable(publishedCoefficients, designNumber, sampleRate);
+    
+    if (designed || parametersChanged)
+        return activePollInterval;
+    
+    return idlePollInterval;
+}
+
+void CoefficientDesigner::parameterChanged(const juce::String&, float)
+{
+    // This can be called from the audio thread: only flag it there. From the message thread (GUI),
+    // wake the background thread straight away.
+    parametersChanged = true;
+    
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        designThread->moveToFrontOfQueue(this);
+}
+
+bool CoefficientDesigner::designAndPublish(bool forceUpdate)
+{
+    auto chainSettings = getChainSettings(parameterValues);
+    const auto threshold = neutralBandThreshold.load();
+    
+    const auto updateLowCut  = forceUpdate || lowCutChanged(chainSettings, lastChainSettings);
+    const auto updateHighCut = forceUpdate || highCutChanged(chainSettings, lastChainSettings);
+    
+    BandMask updateBand {};
+    
+    for (int band = 0; band < maxNumBands; ++band)
+        updateBand[(size_t) band] = forceUpdate || bandChanged(chainSettings, lastChainSettings, band);
+    
+    const auto updateAnyBand = std::find(updateBand.begin(), updateBand.end(), true) != updateBand.end();
+    
+    if (! (updateLowCut || updateHighCut || updateAnyBand))
+        return false;
+    
+    // Only redesign the bands that moved, the others keep their last design
+    // Cut filters come from the table, unless the frequency is off its grid
+    if (updateLowCut)
+    {
+        const Tracer::ScopedEvent traceEvent("design low cut", chainSettings.lowCutSlope);
+        
+        if (! cutFilterTable->lookUp(CutFilterTable::CutType::lowCut, chainSettings.lowCutFreq,
+                                     chainSettings.lowCutSlope, designedCoefficients.lowCut))
+            designedCoefficients.lowCut = makeLowCutCoefficients(chainSettings, sampleRate);
+        
+        designedCoefficients.lowCutSlope = chainSettings.lowCutSlope;
+        lowCutNeutral = isLowCutNeutral(designedCoefficients, sampleRate, threshold);
+    }
+    
+    if (updateHighCut)
+    {
+        const Tracer::ScopedEvent traceEvent("design high cut", chainSettings.highCutSlope);
+        
+        if (! cutFilterTable->lookUp(CutFilterTable::CutType::highCut, chainSettings.highCutFreq,
+                                     chainSettings.highCutSlope, designedCoefficients.highCut))
+            designedCoefficients.highCut = makeHighCutCoefficients(chainSettings, sampleRate);
+        
+        designedCoefficients.highCutSlope = chainSettings.highCutSlope;
+        highCutNeutral = isHighCutNeutral(designedCoefficients, sampleRate, threshold);
+    }
+    
+    for (size_t band = 0; band < updateBand.size(); ++band)
+    {
+        if (! updateBand[band])
+            continue;
+        
+        const auto& bandSettings = chainSettings.bands[band];
+        bandNeutral[band] = isBandNeutral(bandSettings, sampleRate, threshold);
+        
+        // A band that is off (or neutral) is published as pass-through anyway: no need to design it
+        if (bandNeutral[band])
+            continue;
+        
+        const Tracer::ScopedEvent traceEvent("design band", (juce::int64) band);
+        designedCoefficients.bands[band] = makeBandCoefficients(bandSettings, sampleRate);
+    }
+    
+    lastChainSettings = chainSettings;
+    
+    // The designs themselves are kept, only the published copy has its neutral bands skipped
+    auto& published = coefficientBuffer.getWriteBuffer();
+    published = designedCoefficients;
+    skipNeutralBands(published, lowCutNeutral, bandNeutral, highCutNeutral);
+    
+    tailLengthSeconds = getTailLengthInSamples(published) / sampleRate;
+    
+    publishedCoefficients = published;
+    ++designNumber;
+    
+    coefficientBuffer.publish();
+    
+    // The same design for the editor, so it draws exactly what the audio thread runs
+    auto& snapshot = snapshotBuffer.getWriteBuffer();
+    snapshot.coefficients = publishedCoefficients;
+    snapshot.sampleRate = sampleRate;
+    snapshot.version = designNumber;
+    
+    snapshotBuffer.publish();
+    
+    {
+        const juce::SpinLock::ScopedLockType lock(notifierLock);
+        
+        if (publishNotifier != nullptr)
+            publishNotifier->triggerAsyncUpdate();
+    }
+    
+    return true;
+}
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    CoefficientDesigner.h
+    Designs the filter coefficients away from the audio thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+#include "TripleBuffer.h"
+#include "CutFilterTable.h"
+
+// A published design as the audio thread runs it, for the editor. Never changed once published.
+struct CoefficientSnapshot
+{
+    ChainCoefficients coefficients;   // Neutral bands already skipped (see skipNeutralBands)
+    double sampleRate {0.0};
+    juce::uint32 version {0};         // Goes up with every design, 0 before the first one
+};
+
+//==============================================================================
+/**
+    Watches the parameters of the apvts and redesigns the bands whose settings moved
+    on a background thread (one thread shared by every instance of the plugin).
+ 
+    Finished coefficient sets are published through a TripleBuffer, so the audio
+    thread only ever picks up a ready-made snapshot: no design work, no lock, no
+    allocation in processBlock.
+*/
+class CoefficientDesigner : private juce::TimeSliceClient,
+                            private juce::AudioProcessorValueTreeState::Listener
+{
+public:
+    CoefficientDesigner(juce::AudioProcessorValueTreeState& apvts);
+    ~CoefficientDesigner() override;
+    
+    // Gets the published designs on the background thread, so heavier work derived from them
+    // (e.g. the FIR of the LinearPhaseFilter) runs there as well
+    struct Listener
+    {
+        virtual ~Listener() = default;
+        
+        // Called after every time slice of the designer with the last design it published, and
+        // from prepare() with the first one. designNumber goes up with every new design.
+        virtual void designAvailable(const ChainCoefficients& design, juce::uint32 designNumber, double sampleRate) = 0;
+    };
+    
+    // A single listener. Set it before prepare(), it must outlive the designer or be removed first.
+    void setListener(Listener* newListener) noexcept { listener = newListener; }
+    
+    // Designs every band for the new sample rate and publishes it straight away, then
+    // starts following the parameters in the background. Not to be called from the audio thread.
+    void prepare(double sampleRate);
+    
+    // Stops the background work, e.g. when playback stops
+    void release();
+    
+    // Asks for every band to be redesigned (e.g. after a state load). Safe from any thread.
+    void triggerFullUpdate() noexcept;
+    
+    // Bands whose effect stays below this (in db) across the audible range are published as
+    // skipped (see skipNeutralBands). Safe from any thread.
+    void setNeutralBandThreshold(float decibels) noexcept;
+    float getNeutralBandThreshold() const noexcept { return neutralBandThreshold.load(); }
+    
+    static constexpr float defaultNeutralBandThreshold = 0.1f;
+    
+    // Tail of the last published design, in seconds (see getTailLengthInSamples). Safe from any thread.
+    double getTailLengthSeconds() const noexcept { return tailLengthSeconds.load(); }
+    
+    // Triggered after every published design, from the thread that designed it (never the audio
+    // thread), e.g. for the editor to pick up the new snapshot without polling. Set it back to
+    // nullptr before the updater is deleted. Safe from any thread.
+    void setPublishNotifier(juce::AsyncUpdater* notifier) noexcept;
+    
+    // ---------------------- Editor (message thread) ----------------
+    
+    // Same hand over as the audio thread's, through a buffer of its own: a single reader
+    bool pullSnapshot() noexcept { return snapshotBuffer.pull(); }
+    const CoefficientSnapshot& getSnapshot() const noexcept { return snapshotBuffer.getReadBuffer(); }
+    
+    // ---------------------- Audio thread ---------------------------
+    
+    // Returns true if a new snapshot was published since the last call
+    bool pullLatest() noexcept { return coefficientBuffer.pull(); }
+    
+    // Snapshot picked up by the last successful pullLatest()
+    const ChainCoefficients& getLatest() const noexcept { return coefficientBuffer.getReadBuffer(); }
+    
+    // Memory of the cut filter table in use, in bytes (shared with the other instances at the same sample rate)
+    size_t getCutFilterTableMemory() const noexcept { return cutFilterTable != nullptr ? cutFilterTable->getMemoryUsage() : 0; }
+    
+private:
+    int useTimeSlice() override;
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    
+    // Redesigns the bands that changed and publishes the result. Returns false if nothing moved.
+    bool designAndPublish(bool forceUpdate);
+    
+    // Background thread shared between all the instances
+    struct DesignThread : juce::TimeSliceThread
+    {
+        DesignThread();
+        ~DesignThread() override;
+    };
+    
+    juce::SharedResourcePointer<DesignThread> designThread;
+    
+    // Cut designs for the current sample rate, built once and shared between the instances
+    juce::SharedResourcePointer<CutFilterTableCache> cutFilterTableCache;
+    std::shared_ptr<const CutFilterTable> cutFilterTable;
+    
+    juce::AudioProcessorValueTreeState& apvts;
+    ParameterValues parameterValues;
+    
+    double sampleRate {0.0};
+    bool isRunning {false}; // Only used by prepare() / release()
+    
+    // Only touched by the thread that designs (background thread, or prepare() while it is stopped)
+    ChainSettings lastChainSettings;
+    ChainCoefficients designedCoefficients;
+    bool lowCutNeutral {false}, highCutNeutral {false};
+    BandMask bandNeutral {};
+    
+    std::atomic<float> neutralBandThreshold {defaultNeutralBandThreshold};
+    std::atomic<double> tailLengthSeconds {0.0};
+    
+    // Held while the notifier is triggered, so it can't be deleted in the middle
+    juce::SpinLock notifierLock;
+    juce::AsyncUpdater* publishNotifier {nullptr};
+    
+    // Last published design and its number, for the listener (design thread only)
+    Listener* listener {nullptr};
+    ChainCoefficients publishedCoefficients;
+    juce::uint32 designNumber {0};
+    
+    std::atomic<bool> parametersChanged {false};
+    std::atomic<bool> forceFullUpdate {false};
+    
+    TripleBuffer<ChainCoefficients> coefficientBuffer;
+    TripleBuffer<CoefficientSnapshot> snapshotBuffer;
+    
+    // Poll intervals of the background thread (ms): short while parameters are moving, as
+    // automation comes in bursts, then backing off when everything is still.
+    static constexpr int activePollInterval = 1;
+    static constexpr int idlePollInterval = 20;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CoefficientDesigner)
+};
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    CoefficientSmoother.h
+    Ramps the filters from one designed snapshot to the next, one sub-block at a time.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+//==============================================================================
+/**
+    Linear ramp between two ChainCoefficients snapshots, advanced in fixed steps.
+ 
+    The processor calls getNextCoefficients() once every sub-block (16 to 64 samples)
+    while a ramp is running, so the coefficients move smoothly instead of jumping once
+    per host block, and the number of updates per second only depends on the sample
+    rate and the sub-block size, not on the host buffer size.
+ 
+    Every biquad is interpolated on its normalised coefficients: the stability region of
+    (a1, a2) is convex, so a ramp between two stable biquads stays stable. Sections that
+    only exist on one side of a slope change are ramped from/to a pass-through biquad, and
+    so are the bands that are being skipped or brought back (see skipNeutralBands).
+*/
+class CoefficientSmoother
+{
+public:
+    CoefficientSmoother() = default;
+    
+    // Jumps straight to the given coefficients, no ramp
+    void reset(const ChainCoefficients& coefficients) noexcept
+    {
+        start = target = current = coefficients;
+        remainingSteps = 0;
+    }
+    
+    // Number of steps (sub-blocks) a ramp takes to reach its target
+    void setRampLength(int numSteps) noexcept
+    {
+        rampLength = juce::jmax(1, numSteps);
+        remainingSteps = juce::jmin(remainingSteps, rampLength);
+    }
+    
+    // Starts a new ramp from wherever we are now
+    void setTarget(const ChainCoefficients& newTarget) noexcept
+    {
+        start = current;
+        target = newTarget;
+        remainingSteps = rampLength;
+    }
+    
+    bool isSmoothing() const noexcept { return remainingSteps > 0; }
+    
+    // Advances the ramp by one step and returns the coefficients to use for the next sub-block
+    const ChainCoefficients& getNextCoefficients() noexcept
+    {
+        if (remainingSteps <= 0)
+            return current;
+        
+        --remainingSteps;
+        
+        if (remainingSteps == 0)
+        {
+            current = target;
+            return current;
+        }
+        
+        const auto t = 1.0f - static_cast<float>(remainingSteps) / static_cast<float>(rampLength);
+        
+        // While the ramp runs, the sections of both slopes are active
+        current.lowCutSlope = juce::jmax(start.lowCutSlope, target.lowCutSlope);
+        current.highCutSlope = juce::jmax(start.highCutSlope, target.highCutSlope);
+        
+        // Same for the bands being skipped or coming back: they run until they reach (or as they
+        // leave) pass-through, which is what a skipped band's coefficients are
+        current.lowCutActive = start.lowCutActive || target.lowCutActive;
+        current.highCutActive = start.highCutActive || target.highCutActive;
+        
+        for (size_t i = 0; i < current.lowCut.size(); ++i)
+        {
+            current.lowCut[i] = interpolate(start.lowCut[i], target.lowCut[i], t);
+            current.highCut[i] = interpolate(start.highCut[i], target.highCut[i], t);
+        }
+        
+        // A band that is off on both sides stays off: it costs nothing during the ramp either
+        for (size_t i = 0; i < current.bands.size(); ++i)
+        {
+            current.bandActive[i] = start.bandActive[i] || target.bandActive[i];
+            
+            if (current.bandActive[i])
+                current.bands[i] = interpolate(start.bands[i], target.bands[i], t);
+        }
+        
+        return current;
+    }
+    
+    const ChainCoefficients& getCurrentCoefficients() const noexcept { return current; }
+    
+private:
+    static BiquadCoefficients interpolate(const BiquadCoefficients& a, const BiquadCoefficients& b, float t) noexcept
+    {
+        return { a.b0 + (b.b0 - a.b0) * t,
+                 a.b1 + (b.b1 - a.b1) * t,
+                 a.b2 + (b.b2 - a.b2) * t,
+                 a.a1 + (b.a1 - a.a1) * t,
+                 a.a2 + (b.a2 - a.a2) * t };
+    }
+    
+    ChainCoefficients start, target, current;
+    
+    int rampLength {1};
+    int remainingSteps {0};
+};
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    CutFilterTable.cpp
+    Precomputed low/high cut designs for every frequency of the parameter range.
+
+  ==============================================================================
+*/
+
+#include "CutFilterTable.h"
+
+//==============================================================================
+CutFilterTable::CutFilterTable(double rate) : sampleRate(rate)
+{
+    values.resize((size_t) 2 * numFrequencies * sectionsPerFrequency * valuesPerSection);
+    
+    ChainSettings settings;
+    
+    for (int i = 0; i < numFrequencies; ++i)
+    {
+        settings.lowCutFreq = settings.highCutFreq = static_cast<float>(minFrequency + i);
+        
+        for (auto slope : { Slope_12, Slope_24, Slope_36, Slope_48 })
+        {
+            settings.lowCutSlope = settings.highCutSlope = slope;
+            
+            // Designed with the same functions as the ones we replace, so a lookup is exact
+            auto store = [&](CutType type, const CutCoefficients& sections)
+            {
+                auto* entry = values.data() + getIndex(type, i, slope);
+                
+                for (int section = 0; section <= slope; ++section)
+                {
+                    const auto& c = sections[(size_t) section];
+                    *entry++ = c.b0;
+                    *entry++ = c.a1;
+                    *entry++ = c.a2;
+                }
+            };
+            
+            store(CutType::lowCut, makeLowCutCoefficients(settings, sampleRate));
+            store(CutType::highCut, makeHighCutCoefficients(settings, sampleRate));
+        }
+    }
+}
+
+bool CutFilterTable::lookUp(CutType type, float frequency, SlopeSettings slope, CutCoefficients& sections) const noexcept
+{
+    // The parameters move in 1 Hz steps, anything else is not in the table
+    const auto index = static_cast<int>(frequency) - minFrequency;
+    
+    if (static_cast<float>(index + minFrequency) != frequency || ! juce::isPositiveAndBelow(index, numFrequencies))
+        return false;
+    
+    // High pass (low cut) has b1 == -2 * gain, low pass (high cut) b1 == 2 * gain
+    const auto b1Factor = type == CutType::lowCut ? -2.0f : 2.0f;
+    
+    const auto* entry = values.data() + getIndex(type, index, slope);
+    
+    // Sections above the slope stay pass-through
+    sections = {};
+    
+    for (int section = 0; section <= slope; ++section)
+    {
+        auto& c = sections[(size_t) section];
+        const auto gain = *entry++;
+        
+        c.b0 = gain;
+        c.b1 = gain * b1Factor;
+        c.b2 = gain;
+        c.a1 = *entry++;
+        c.a2 = *entry++;
+    }
+    
+    return true;
+}
+
+//==============================================================================
+std::shared_ptr<const CutFilterTable> CutFilterTableCache::getTable(double sampleRate)
+{
+    const juce::ScopedLock sl(lock);
+    
+    // Forget the tables nobody uses anymore
+    tables.erase(std::remove_if(tables.begin(), tables.end(), [](const auto& table) { return table.expired(); }),
+                 tables.end());
+    
+    for (auto& weakTable : tables)
+        if (auto table = weakTable.lock())
+            if (table->getSampleRate() == sampleRate)
+                return table;
+    
+    auto table = std::make_shared<const CutFilterTable>(sampleRate);
+    tables.push_back(table);
+    
+    return table;
+}
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    CutFilterTable.h
+    Precomputed low/high cut designs for every frequency of the parameter range.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+//==============================================================================
+/**
+    Every Butterworth cut design the parameters can ask for at one sample rate.
+ 
+    The cut frequencies go from 20 Hz to 20 kHz in 1 Hz steps and there are only four
+    slopes, so all of them are designed once up front: moving a cut frequency becomes a
+    table read instead of a design.
+ 
+    Each 12db section only needs 3 values: the low and high pass designs both have
+    b0 == b2 == gain and b1 == +/-2 * gain once normalised. A lookup gives exactly the
+    same coefficients as makeLowCutCoefficients() / makeHighCutCoefficients().
+*/
+class CutFilterTable
+{
+public:
+    enum class CutType
+    {
+        lowCut,
+        highCut
+    };
+    
+    // Frequency grid of the table, the same as the cut frequency parameters
+    static constexpr int minFrequency = 20;
+    static constexpr int maxFrequency = 20000;
+    
+    // Designs every entry (a few milliseconds): not for the audio thread
+    explicit CutFilterTable(double sampleRate);
+    
+    double getSampleRate() const noexcept { return sampleRate; }
+    
+    // Fills the sections of the given cut filter. Returns false if the frequency is not on the
+    // grid of the table, in which case the caller has to design it.
+    bool lookUp(CutType type, float frequency, SlopeSettings slope, CutCoefficients& sections) const noexcept;
+    
+    // Memory used by the table, in bytes
+    size_t getMemoryUsage() const noexcept { return values.size() * sizeof(float); }
+    
+private:
+    // 1 + 2 + 3 + 4 sections: every slope of one cut type, for one frequency
+    static constexpr int sectionsPerFrequency = 10;
+    
+    // gain, a1, a2
+    static constexpr int valuesPerSection = 3;
+    
+    static constexpr int numFrequencies = maxFrequency - minFrequency + 1;
+    
+    // Index of the first section of a slope, within one frequency
+    static constexpr int getSlopeOffset(SlopeSettings slope) noexcept
+    {
+        return slope * (slope + 1) / 2;
+    }
+    
+    size_t getIndex(CutType type, int frequencyIndex, SlopeSettings slope) const noexcept
+    {
+        return (((size_t) type * numFrequencies + (size_t) frequencyIndex) * sectionsPerFrequency
+                + (size_t) getSlopeOffset(slope)) * valuesPerSection;
+    }
+    
+    double sampleRate;
+    std::vector<float> values;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CutFilterTable)
+};
+
+//==============================================================================
+/**
+    Hands out the tables, so that every instance running at the same sample rate shares
+    one. A table is built the first time a sample rate is asked for, and freed when the
+    last instance using it lets it go. Meant to be used through a SharedResourcePointer.
+*/
+class CutFilterTableCache
+{
+public:
+    std::shared_ptr<const CutFilterTable> getTable(double sampleRate);
+    
+private:
+    juce::CriticalSection lock;
+    std::vector<std::weak_ptr<const CutFilterTable>> tables;
+};
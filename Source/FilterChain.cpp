@@ -0,0 +1,331 @@
+/*
+  ==============================================================================
+
+    FilterChain.cpp
+    Filter types, chain settings and the free functions designing the coefficients.
+
+  ==============================================================================
+*/
+
+#include "FilterChain.h"
+
+// Getting the parameter's values using the ChainSettings structure
+ChainSettings getChainSettings(const ParameterValues& parameters)
+{
+    ChainSettings settings;
+    
+    // Gets settings in the range we have defined the sliders. For normalised values, use apvts.getParameter()
+    settings.lowCutFreq = parameters.get(LowCutFreq);
+    settings.highCutFreq = parameters.get(HighCutFreq);
+    settings.lowCutSlope = static_cast<SlopeSettings> (parameters.getChoice(LowCutSlope));
+    settings.highCutSlope = static_cast<SlopeSettings> (parameters.getChoice(HighCutSlope));
+    
+    for (size_t i = 0; i < settings.bands.size(); ++i)
+    {
+        const auto& indices = bandParameterTable[i];
+        auto& band = settings.bands[i];
+        
+        band.type = static_cast<BandType> (parameters.getChoice(indices.type));
+        band.enabled = parameters.getBool(indices.enabled);
+        band.freq = parameters.get(indices.freq);
+        band.gainInDecibels = parameters.get(indices.gain);
+        band.quality = parameters.get(indices.quality);
+    }
+
+    return settings;
+}
+
+// Free functions (non-member functions), the designs themselves are in BiquadDesign.h
+BiquadCoefficients makeBandCoefficients(const BandSettings& bandSettings, double sampleRate)
+{
+    BiquadCoefficients band;
+    const auto gainFactor = juce::Decibels::decibelsToGain((double) bandSettings.gainInDecibels);
+    
+    switch (bandSettings.type)
+    {
+        case Band_Peak:
+            designPeak(band, sampleRate, bandSettings.freq, bandSettings.quality, gainFactor);
+            break;
+            
+        case Band_LowShelf:
+            designLowShelf(band, sampleRate, bandSettings.freq, bandSettings.quality, gainFactor);
+            break;
+            
+        case Band_HighShelf:
+            designHighShelf(band, sampleRate, bandSettings.freq, bandSettings.quality, gainFactor);
+            break;
+            
+        case Band_Notch:
+            designNotch(band, sampleRate, bandSettings.freq, bandSettings.quality);
+            break;
+    }
+    
+    return band;
+}
+
+// ------------------------------------------------------------------------------------
+// Butterworth cut filters of order 2, 4, 6 or 8: slope choice [0,1,2,3] --> +1 --> [1, 2, 3, 4] sections.
+// Sections that are not used by the slope are left as pass-through.
+// ------------------------------------------------------------------------------------
+CutCoefficients makeLowCutCoefficients(const ChainSettings& chainSettings, double sampleRate)
+{
+    CutCoefficients sections;
+    designButterworthHighPass(sections.data(), chainSettings.lowCutSlope + 1, sampleRate, chainSettings.lowCutFreq);
+    return sections;
+}
+
+CutCoefficients makeHighCutCoefficients(const ChainSettings& chainSettings, double sampleRate)
+{
+    CutCoefficients sections;
+    designButterworthLowPass(sections.data(), chainSettings.highCutSlope + 1, sampleRate, chainSettings.highCutFreq);
+    return sections;
+}
+
+ChainCoefficients makeChainCoefficients(const ChainSettings& chainSettings, double sampleRate)
+{
+    ChainCoefficients chainCoefficients;
+    
+    chainCoefficients.lowCut = makeLowCutCoefficients(chainSettings, sampleRate);
+    chainCoefficients.highCut = makeHighCutCoefficients(chainSettings, sampleRate);
+    chainCoefficients.lowCutSlope = chainSettings.lowCutSlope;
+    chainCoefficients.highCutSlope = chainSettings.highCutSlope;
+    
+    // The bands that are off stay pass-through
+    for (size_t i = 0; i < chainSettings.bands.size(); ++i)
+    {
+        const auto& band = chainSettings.bands[i];
+        
+        if (band.enabled)
+            chainCoefficients.bands[i] = makeBandCoefficients(band, sampleRate);
+        
+        chainCoefficients.bandActive[i] = band.enabled;
+    }
+    
+    return chainCoefficients;
+}
+
+template<typename SampleType>
+void prepareCoefficientStorage(MonoChainType<SampleType>& chain)
+{
+    // Pass-through biquad: gives the filter its final coefficient count, so the state
+    // allocated by prepare() already has the right order
+    auto prepareFilter = [](FilterType<SampleType>& filter)
+    {
+        *filter.coefficients = juce::dsp::IIR::Coefficients<SampleType>(1, 0, 0, 1, 0, 0);
+    };
+    
+    auto prepareCutFilter = [&](CutFilterType<SampleType>& cut)
+    {
+        prepareFilter(cut.template get<0>());
+        prepareFilter(cut.template get<1>());
+        prepareFilter(cut.template get<2>());
+        prepareFilter(cut.template get<3>());
+    };
+    
+    // The bands keep their coefficients in fixed size arrays, they need nothing
+    prepareCutFilter(chain.template get<ChainPositions::LowCut>());
+    prepareCutFilter(chain.template get<ChainPositions::HighCut>());
+}
+
+// Getting the coefficients from above (chain.get), so we write through the pointer
+template<typename SampleType>
+void updateCoefficients(CoefficientsPtr<SampleType>& old, const BiquadCoefficients& replacements)
+{
+    // Size was set once by prepareCoefficientStorage, we only overwrite the values
+    jassert(old->coefficients.size() == 5);
+    
+    auto* c = old->getRawCoefficients();
+    c[0] = replacements.b0;
+    c[1] = replacements.b1;
+    c[2] = replacements.b2;
+    c[3] = replacements.a1;
+    c[4] = replacements.a2;
+}
+
+template<typename SampleType>
+void updateChain(MonoChainType<SampleType>& chain, const ChainCoefficients& chainCoefficients)
+{
+    // ------------------------------------------------------------------------------------
+    // Access each link in the chain and assign the coefficients.
+    // The coefficients were designed as plain data by the CoefficientDesigner and are copied
+    // into the arrays allocated in prepareToPlay: no allocation on the heap in the audio callback.
+    // ------------------------------------------------------------------------------------
+    // Skipped bands are bypassed as a whole, they start from a clean state when they come back
+    auto updateCut = [](CutFilterType<SampleType>& cut, const CutCoefficients& coefficients, SlopeSettings slope, bool active)
+    {
+        if (active)
+        {
+            updateCutFilter(cut, coefficients, slope);
+            return;
+        }
+        
+        cut.template setBypassed<0>(true);
+        cut.template setBypassed<1>(true);
+        cut.template setBypassed<2>(true);
+        cut.template setBypassed<3>(true);
+    };
+    
+    updateCut(chain.template get<ChainPositions::LowCut>(), chainCoefficients.lowCut,
+              chainCoefficients.lowCutSlope, chainCoefficients.lowCutActive);
+    
+    // Only the running bands are copied, the others don't take any time when processing
+    chain.template get<ChainPositions::Bands>().setCoefficients(chainCoefficients.bands, chainCoefficients.bandActive);
+    
+    updateCut(chain.template get<ChainPositions::HighCut>(), chainCoefficients.highCut,
+              chainCoefficients.highCutSlope, chainCoefficients.highCutActive);
+}
+
+template<typename SampleType>
+void processChain(MonoChainType<SampleType>& chain,
+                  const juce::dsp::ProcessContextReplacing<SampleType>& context,
+                  const ActiveSections& sections)
+{
+    withNumSections(sections.lowCut, [&](auto numLowCut)
+    {
+        processCutFilter<decltype(numLowCut)::value>(chain.template get<ChainPositions::LowCut>(), context);
+    });
+    
+    // Picks its specialisation from the number of bands running
+    chain.template get<ChainPositions::Bands>().process(context);
+    
+    withNumSections(sections.highCut, [&](auto numHighCut)
+    {
+        processCutFilter<decltype(numHighCut)::value>(chain.template get<ChainPositions::HighCut>(), context);
+    });
+}
+
+// The chains only come in float and double
+template void prepareCoefficientStorage<float>(MonoChainType<float>&);
+template void prepareCoefficientStorage<double>(MonoChainType<double>&);
+template void updateCoefficients<float>(CoefficientsPtr<float>&, const BiquadCoefficients&);
+template void updateCoefficients<double>(CoefficientsPtr<double>&, const BiquadCoefficients&);
+template void updateChain<float>(MonoChainType<float>&, const ChainCoefficients&);
+template void updateChain<double>(MonoChainType<double>&, const ChainCoefficients&);
+template void processChain<float>(MonoChainType<float>&, const juce::dsp::ProcessContextReplacing<float>&, const ActiveSections&);
+template void processChain<double>(MonoChainType<double>&, const juce::dsp::ProcessContextReplacing<double>&, const ActiveSections&);
+
+//==============================================================================
+// Magnitude of the first numSections biquads of a cut filter, in decibels
+static double getCutMagnitudeInDecibels(const CutCoefficients& sections, SlopeSettings slope,
+                                        double frequency, double sampleRate)
+{
+    double magnitude = 1.0;
+    
+    for (int i = 0; i <= slope; ++i)
+        magnitude *= getMagnitudeForFrequency(sections[(size_t) i], frequency, sampleRate);
+    
+    return juce::Decibels::gainToDecibels(magnitude, -300.0);
+}
+
+bool isLowCutNeutral(const ChainCoefficients& chainCoefficients, double sampleRate, float thresholdInDecibels)
+{
+    // The high pass removes the most at the bottom of the range
+    const auto deviation = getCutMagnitudeInDecibels(chainCoefficients.lowCut, chainCoefficients.lowCutSlope,
+                                                     20.0, sampleRate);
+    
+    return std::abs(deviation) < thresholdInDecibels;
+}
+
+bool isHighCutNeutral(const ChainCoefficients& chainCoefficients, double sampleRate, float thresholdInDecibels)
+{
+    // The low pass removes the most at the top of the range (or at Nyquist, if that comes first)
+    const auto deviation = getCutMagnitudeInDecibels(chainCoefficients.highCut, chainCoefficients.highCutSlope,
+                                                     juce::jmin(20000.0, sampleRate * 0.5), sampleRate);
+    
+    return std::abs(deviation) < thresholdInDecibels;
+}
+
+// Largest deviation from 0db of a biquad over the audible range, in decibels. The grid is 1/48 of an
+// octave: the overshoot of a shelf at the highest Q spans several points, its top is not missed.
+static double getMaxDeviationInDecibels(const BiquadCoefficients& coefficients, double sampleRate)
+{
+    const auto top = juce::jmin(20000.0, sampleRate * 0.5);
+    const auto step = std::pow(2.0, 1.0 / 48.0);
+    
+    double deviation = 0.0;
+    
+    for (auto frequency = 20.0; frequency < top * step; frequency *= step)
+    {
+        const auto magnitude = getMagnitudeForFrequency(coefficients, juce::jmin(frequency, top), sampleRate);
+        deviation = juce::jmax(deviation, std::abs(juce::Decibels::gainToDecibels(magnitude, -300.0)));
+    }
+    
+    return deviation;
+}
+
+bool isBandNeutral(const BandSettings& bandSettings, double sampleRate, float thresholdInDecibels)
+{
+    if (! bandSettings.enabled)
+        return true;
+    
+    // Full rejection at its frequency, whatever the gain
+    if (bandSettings.type == Band_Notch)
+        return false;
+    
+    // Reaching the threshold at its own gain is never neutral, only the smaller ones need a closer look
+    if (std::abs(bandSettings.gainInDecibels) >= thresholdInDecibels)
+        return false;
+    
+    // The peak is at its full gain at its frequency, and nowhere above it
+    if (bandSettings.type == Band_Peak)
+        return true;
+    
+    // A shelf can overshoot its own gain: measure it
+    return getMaxDeviationInDecibels(makeBandCoefficients(bandSettings, sampleRate), sampleRate) < thresholdInDecibels;
+}
+
+double getTailLengthInSamples(const ChainCoefficients& chainCoefficients)
+{
+    const auto sections = getActiveSections(chainCoefficients);
+    double length = 0.0;
+    
+    for (int i = 0; i < sections.lowCut; ++i)
+        length += getDecayLengthInSamples(chainCoefficients.lowCut[(size_t) i], silenceInDecibels);
+    
+    for (size_t i = 0; i < chainCoefficients.bands.size(); ++i)
+        if (chainCoefficients.bandActive[i])
+            length += getDecayLengthInSamples(chainCoefficients.bands[i], silenceInDecibels);
+    
+    for (int i = 0; i < sections.highCut; ++i)
+        length += getDecayLengthInSamples(chainCoefficients.highCut[(size_t) i], silenceInDecibels);
+    
+    return length;
+}
+
+double getMagnitudeForFrequency(const ChainCoefficients& chainCoefficients, double frequency, double sampleRate)
+{
+    const auto sections = getActiveSections(chainCoefficients);
+    double magnitude = 1.0;
+    
+    for (int i = 0; i < sections.lowCut; ++i)
+        magnitude *= getMagnitudeForFrequency(chainCoefficients.lowCut[(size_t) i], frequency, sampleRate);
+    
+    for (size_t i = 0; i < chainCoefficients.bands.size(); ++i)
+        if (chainCoefficients.bandActive[i])
+            magnitude *= getMagnitudeForFrequency(chainCoefficients.bands[i], frequency, sampleRate);
+    
+    for (int i = 0; i < sections.highCut; ++i)
+        magnitude *= getMagnitudeForFrequency(chainCoefficients.highCut[(size_t) i], frequency, sampleRate);
+    
+    return magnitude;
+}
+
+void skipNeutralBands(ChainCoefficients& chainCoefficients, bool lowCutNeutral, const BandMask& bandNeutral, bool highCutNeutral)
+{
+    chainCoefficients.lowCutActive = ! lowCutNeutral;
+    chainCoefficients.highCutActive = ! highCutNeutral;
+    
+    if (lowCutNeutral)
+        chainCoefficients.lowCut = {};
+    
+    for (size_t i = 0; i < chainCoefficients.bands.size(); ++i)
+    {
+        chainCoefficients.bandActive[i] = ! bandNeutral[i];
+        
+        if (bandNeutral[i])
+            chainCoefficients.bands[i] = {};
+    }
+    
+    if (highCutNeutral)
+        chainCoefficients.highCut = {};
+}
@@ -0,0 +1,301 @@
+/*
+  ==============================================================================
+
+    FilterChain.h
+    Filter types, chain settings and the free functions designing the coefficients.
+    Shared by the processor, the editor and the background designer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BiquadDesign.h"
+#include "Parameters.h"
+#include "ParametricBands.h"
+
+
+// Enum to express the slope settings
+enum SlopeSettings
+{
+    Slope_12,
+    Slope_24,
+    Slope_36,
+    Slope_48
+};
+
+// Enum for the shape of a parametric band, in the order of the band type parameters
+enum BandType
+{
+    Band_Peak,
+    Band_LowShelf,
+    Band_HighShelf,
+    Band_Notch
+};
+
+// Settings of one parametric band. The gain is not used by the notch.
+struct BandSettings
+{
+    BandType type {BandType::Band_Peak};
+    bool enabled {false};
+    float freq {0}, gainInDecibels {0}, quality {1.0f};
+};
+
+
+// Extracting parameters of apvts, data structure representing all parameters values
+// Parameters from parameterValueTreeState
+struct ChainSettings
+{
+    // Band 1 is the peak of the original plugin
+    std::array<BandSettings, maxNumBands> bands;
+    float lowCutFreq {0}, highCutFreq {0};
+    
+    // Init the cut by the 12db filter
+    SlopeSettings lowCutSlope {SlopeSettings::Slope_12}, highCutSlope {SlopeSettings::Slope_12};
+};
+
+// Helper function giving all the values to the data struct above (indexed reads, no lookup by name)
+ChainSettings getChainSettings(const ParameterValues& parameters);
+
+// Per band change detection: compare two settings and tell if a given band needs to be redesigned
+inline bool lowCutChanged(const ChainSettings& a, const ChainSettings& b)
+{
+    return a.lowCutFreq != b.lowCutFreq || a.lowCutSlope != b.lowCutSlope;
+}
+
+inline bool highCutChanged(const ChainSettings& a, const ChainSettings& b)
+{
+    return a.highCutFreq != b.highCutFreq || a.highCutSlope != b.highCutSlope;
+}
+
+inline bool bandChanged(const ChainSettings& a, const ChainSettings& b, int band)
+{
+    const auto& x = a.bands[(size_t) band];
+    const auto& y = b.bands[(size_t) band];
+    
+    return x.type != y.type
+        || x.enabled != y.enabled
+        || x.freq != y.freq
+        || x.gainInDecibels != y.gainInDecibels
+        || x.quality != y.quality;
+}
+
+// Creating a juce dsp filter 'type alias', for float or double processing
+template<typename SampleType>
+using FilterType = juce::dsp::IIR::Filter<SampleType>;
+
+// We want cutfilter to have a max of 48db reponse. Each filter are 12db response, so we need to
+// 'side-chain' 4 of them to obtain this selectable 12db-48db. We do this using a processor chain.
+// We pass the processor a single context (audio samples) for the 4 filters.
+template<typename SampleType>
+using CutFilterType = juce::dsp::ProcessorChain<FilterType<SampleType>, FilterType<SampleType>,
+                                                FilterType<SampleType>, FilterType<SampleType>>;
+
+// Mono chain: Low cut --> Parametric bands --> High cut
+// We create a mono chain by having 2 cut filters for the low&high cut
+// and the array of parametric bands in between (see ParametricBands.h)
+template<typename SampleType>
+using MonoChainType = juce::dsp::ProcessorChain<CutFilterType<SampleType>, ParametricBands<SampleType>, CutFilterType<SampleType>>;
+
+// Single precision versions, used by the editor and the float processBlock
+using Filter = FilterType<float>;
+using CutFilter = CutFilterType<float>;
+using MonoChain = MonoChainType<float>;
+
+// Largest layout we accept (7.1.4 is 12 channels, 9.1.6 is 16)
+constexpr size_t maxNumChannels = 16;
+
+// Enum representing each filter in the chain. Goes along with the MonoChain above defining each:
+// cut filter, parametric bands, cut filter
+enum ChainPositions
+{
+    LowCut,
+    Bands,
+    HighCut
+};
+
+// -------------------------------------------------------------------------------------------------------
+// All of these update functions are public as 'free' functions, to be utilised by the plugin editor.
+// --> If they use member variables, they need to become function arguments.
+// -------------------------------------------------------------------------------------------------------
+
+
+// Juce coefficient Alias
+template<typename SampleType>
+using CoefficientsPtr = juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<SampleType>>;
+
+// One biquad per 12db section of a cut filter
+using CutCoefficients = std::array<BiquadCoefficients, 4>;
+
+// Everything the audio thread needs to update its chains, designed in one go by the CoefficientDesigner
+struct ChainCoefficients
+{
+    CutCoefficients lowCut, highCut;
+    BandCoefficients bands;
+    
+    SlopeSettings lowCutSlope {SlopeSettings::Slope_12}, highCutSlope {SlopeSettings::Slope_12};
+    
+    // A band that is not active is skipped altogether by the chains: switched off, or neutral
+    // (see isLowCutNeutral & co). Its coefficients are then pass-through, so ramps towards or
+    // away from it are click free.
+    bool lowCutActive {true}, highCutActive {true};
+    BandMask bandActive {};
+};
+
+// Number of biquads the cuts run (0 for a cut that is skipped), and number of parametric bands running
+struct ActiveSections
+{
+    int lowCut {1}, bands {0}, highCut {1};
+};
+
+// Most sections a chain has: 4 low cut, every parametric band, 4 high cut
+constexpr int maxNumChainSections = 4 + maxNumBands + 4;
+
+inline ActiveSections getActiveSections(const ChainCoefficients& chainCoefficients)
+{
+    return { chainCoefficients.lowCutActive ? chainCoefficients.lowCutSlope + 1 : 0,
+             (int) std::count(chainCoefficients.bandActive.begin(), chainCoefficients.bandActive.end(), true),
+             chainCoefficients.highCutActive ? chainCoefficients.highCutSlope + 1 : 0 };
+}
+
+// Helper function to update filter coefficients: writes into the storage the filter already owns
+// (see prepareCoefficientStorage). The designs are single precision, a double filter gets them widened.
+template<typename SampleType>
+void updateCoefficients(CoefficientsPtr<SampleType>& old, const BiquadCoefficients& replacements);
+
+// Gives every filter of the chain a biquad sized coefficient array. Must be called before the chain is
+// prepared, so neither the coefficients nor the filter state ever need to be reallocated while processing.
+template<typename SampleType>
+void prepareCoefficientStorage(MonoChainType<SampleType>& chain);
+
+// Filter designs from the chain settings (see BiquadDesign.h), allocation free.
+// Cut sections above the selected slope are left as pass-through.
+BiquadCoefficients makeBandCoefficients(const BandSettings& bandSettings, double sampleRate);
+CutCoefficients makeLowCutCoefficients(const ChainSettings& chainSettings, double sampleRate);
+CutCoefficients makeHighCutCoefficients(const ChainSettings& chainSettings, double sampleRate);
+
+// Every band at once, the parametric bands that are switched off as skipped
+ChainCoefficients makeChainCoefficients(const ChainSettings& chainSettings, double sampleRate);
+
+// -------------------------------------------------------------------------------------------------------
+// Neutral band detection.
+// A band is neutral when it changes the gain by less than thresholdInDecibels everywhere in the audible
+// range (20Hz - 20kHz), e.g. a peak at 0db. Running it would cost CPU for nothing, so it can be skipped.
+// A peak reaches its full gain at its centre frequency, and the Butterworth cuts are monotonic: their
+// largest effect in the range is at the edge closest to their cutoff. One evaluation is exact for those.
+// A shelf overshoots its gain around the transition when Q goes above 1/sqrt(2) (a 0.09db shelf reaches
+// 0.5db at Q = 10): its deviation is measured over the whole range. A notch is never neutral, a band
+// switched off always is.
+// -------------------------------------------------------------------------------------------------------
+bool isLowCutNeutral(const ChainCoefficients& chainCoefficients, double sampleRate, float thresholdInDecibels);
+bool isHighCutNeutral(const ChainCoefficients& chainCoefficients, double sampleRate, float thresholdInDecibels);
+bool isBandNeutral(const BandSettings& bandSettings, double sampleRate, float thresholdInDecibels);
+
+// Marks the neutral bands as not active and turns them into pass-through
+void skipNeutralBands(ChainCoefficients& chainCoefficients, bool lowCutNeutral, const BandMask& bandNeutral, bool highCutNeutral);
+
+// -------------------------------------------------------------------------------------------------------
+// Tail & silence.
+// The tail is how long the chain keeps ringing after the input stops, down to silenceInDecibels.
+// Input quieter than that counts as silence: once it lasted longer than the tail, the output is silent too.
+// -------------------------------------------------------------------------------------------------------
+constexpr double silenceInDecibels = -120.0;
+
+// Sum of the decay lengths of every active section: an upper bound for the cascade
+double getTailLengthInSamples(const ChainCoefficients& chainCoefficients);
+
+// Magnitude (linear gain) of the whole chain at a given frequency, skipped bands left out
+double getMagnitudeForFrequency(const ChainCoefficients& chainCoefficients, double frequency, double sampleRate);
+
+// Template function
+template<int Index, typename ChainType, typename CoefficientType>
+void update(ChainType& chain, const CoefficientType& coefficients)
+{
+    // A link coming back from bypass starts from a clean state: the one it kept is stale
+    if (chain.template isBypassed<Index>())
+        chain.template get<Index>().reset();
+    
+    updateCoefficients(chain.template get<Index>().coefficients, coefficients[Index]);
+    chain.template setBypassed<Index> (false);
+}
+
+// Low/high cut filter coefficient update
+template<typename ChainType, typename CoefficientType>
+void updateCutFilter(ChainType& leftLowCut,
+                     const CoefficientType& cutCoefficients,
+                     const SlopeSettings& lowCutSlope)
+{
+    // Updates filter coefficients depending on which slope is selected
+    switch (lowCutSlope)
+    {
+        // Reversing case order and removing breaks to avoid duplicate code
+        case Slope_48:
+        {
+            update<3>(leftLowCut, cutCoefficients);
+        }
+        case Slope_36:
+        {
+            update<2>(leftLowCut, cutCoefficients);
+        }
+        case Slope_24:
+        {
+            update<1>(leftLowCut, cutCoefficients);
+        }
+        case Slope_12:
+        {
+            update<0>(leftLowCut, cutCoefficients);
+        }
+    }
+    
+    // Bypass the links above the selected slope
+    leftLowCut.template setBypassed<1>(lowCutSlope < Slope_24);
+    leftLowCut.template setBypassed<2>(lowCutSlope < Slope_36);
+    leftLowCut.template setBypassed<3>(lowCutSlope < Slope_48);
+}
+
+// Copies a designed snapshot into a chain: coefficients and bypass states (no allocation)
+template<typename SampleType>
+void updateChain(MonoChainType<SampleType>& chain, const ChainCoefficients& chainCoefficients);
+
+// -------------------------------------------------------------------------------------------------------
+// Compile time slope specialisation.
+// The slope only changes once per block at most, so instead of checking a bypass flag per section
+// while processing, we pick the cascade built for that exact number of sections once per block.
+// -------------------------------------------------------------------------------------------------------
+
+// Calls function(std::integral_constant<int, N>) with N = numSections (0 to 4, 0 for a skipped band)
+template<typename Function>
+void withNumSections(int numSections, Function&& function)
+{
+    jassert(numSections >= 0 && numSections <= 4);
+    
+    switch (numSections)
+    {
+        case 0:  function(std::integral_constant<int, 0>{}); break;
+        case 1:  function(std::integral_constant<int, 1>{}); break;
+        case 2:  function(std::integral_constant<int, 2>{}); break;
+        case 3:  function(std::integral_constant<int, 3>{}); break;
+        default: function(std::integral_constant<int, 4>{}); break;
+    }
+}
+
+// Runs the first NumSections links of a cut filter, without looking at their bypass state
+template<int NumSections, typename SampleType>
+void processCutFilter(CutFilterType<SampleType>& cut, const juce::dsp::ProcessContextReplacing<SampleType>& context)
+{
+    if constexpr (NumSections > 1)
+        processCutFilter<NumSections - 1>(cut, context);
+    
+    if constexpr (NumSections > 0)
+        cut.template get<NumSections - 1>().process(context);
+}
+
+// Processes a block through the chain, running only the active sections of every band.
+// Same result as chain.process(context) after updateChain, minus the per link bypass checks.
+// Each part of the chain is specialised on its own (see withNumSections and withNumBands), so
+// the number of specialisations grows with the number of bands, not with their product.
+template<typename SampleType>
+void processChain(MonoChainType<SampleType>& chain,
+                  const juce::dsp::ProcessContextReplacing<SampleType>& context,
+                  const ActiveSections& sections);
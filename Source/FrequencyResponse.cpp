@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    FrequencyResponse.cpp
+    Magnitude, phase and group delay of the chain at many frequencies in one call.
+
+  ==============================================================================
+*/
+
+#include "FrequencyResponse.h"
+
+namespace
+{
+    // Points done together: small enough for the working arrays to stay in L1 cache
+    constexpr int blockSize = 64;
+
+    // A zero right on the frequency (the cut filters have them at 0Hz and Nyquist) would divide by 0
+    constexpr double smallestSquaredMagnitude = 1.0e-300;
+}
+
+//==============================================================================
+// For every section, with z = e^(jw):
+//   N(w) = b0 + b1.z^-1 + b2.z^-2    D(w) = 1 + a1.z^-1 + a2.z^-2
+// The response is the product of the N / D. The group delay of a polynomial P(z^-1) is
+// Re(P~ / P) with P~ = sum(k.p_k.z^-k), so each section adds Re(N~ / N) - Re(D~ / D).
+// N / D is accumulated as N.conj(D) and |D|^2 separately, to divide only once per point.
+//==============================================================================
+void computeFrequencyResponse(const BiquadCoefficients* sections, int numSections,
+                              const double* frequencies, int numFrequencies, double sampleRate,
+                              const FrequencyResponseOutput& output) noexcept
+{
+    alignas(32) double cos1[blockSize], sin1[blockSize], cos2[blockSize], sin2[blockSize];
+    alignas(32) double real[blockSize], imag[blockSize], denominator[blockSize], groupDelay[blockSize];
+
+    const auto omegaPerHertz = juce::MathConstants<double>::twoPi / sampleRate;
+
+    for (int start = 0; start < numFrequencies; start += blockSize)
+    {
+        const auto numPoints = juce::jmin(blockSize, numFrequencies - start);
+
+        // The only transcendental functions: one sine and one cosine per point, shared by every section
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto omega = frequencies[start + i] * omegaPerHertz;
+            cos1[i] = std::cos(omega);
+            sin1[i] = std::sin(omega);
+            cos2[i] = cos1[i] * cos1[i] - sin1[i] * sin1[i];
+            sin2[i] = 2.0 * sin1[i] * cos1[i];
+
+            real[i] = 1.0;
+            imag[i] = 0.0;
+            denominator[i] = 1.0;
+            groupDelay[i] = 0.0;
+        }
+
+        for (int section = 0; section < numSections; ++section)
+        {
+            const auto b0 = (double) sections[section].b0;
+            const auto b1 = (double) sections[section].b1;
+            const auto b2 = (double) sections[section].b2;
+            const auto a1 = (double) sections[section].a1;
+            const auto a2 = (double) sections[section].a2;
+
+            // No branch in here: this is the loop that gets vectorised
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const auto numeratorReal = b0 + b1 * cos1[i] + b2 * cos2[i];
+                const auto numeratorImag = -(b1 * sin1[i] + b2 * sin2[i]);
+                const auto denominatorReal = 1.0 + a1 * cos1[i] + a2 * cos2[i];
+                const auto denominatorImag = -(a1 * sin1[i] + a2 * sin2[i]);
+
+                const auto numeratorSquared = std::max(numeratorReal * numeratorReal + numeratorImag * numeratorImag, smallestSquaredMagnitude);
+                const auto denominatorSquared = std::max(denominatorReal * denominatorReal + denominatorImag * denominatorImag, smallestSquaredMagnitude);
+
+                // Weighted polynomials N~ and D~
+                const auto weightedNumeratorReal = b1 * cos1[i] + 2.0 * b2 * cos2[i];
+                const auto weightedNumeratorImag = -(b1 * sin1[i] + 2.0 * b2 * sin2[i]);
+                const auto weightedDenominatorReal = a1 * cos1[i] + 2.0 * a2 * cos2[i];
+                const auto weightedDenominatorImag = -(a1 * sin1[i] + 2.0 * a2 * sin2[i]);
+
+                groupDelay[i] += (weightedNumeratorReal * numeratorReal + weightedNumeratorImag * numeratorImag) / numeratorSquared
+                               - (weightedDenominatorReal * denominatorReal + weightedDenominatorImag * denominatorImag) / denominatorSquared;
+
+                // (real + j.imag) *= N.conj(D)
+                const auto sectionReal = numeratorReal * denominatorReal + numeratorImag * denominatorImag;
+                const auto sectionImag = numeratorImag * denominatorReal - numeratorReal * denominatorImag;
+
+                const auto newReal = real[i] * sectionReal - imag[i] * sectionImag;
+                imag[i] = real[i] * sectionImag + imag[i] * sectionReal;
+                real[i] = newReal;
+
+                denominator[i] *= denominatorSquared;
+            }
+        }
+
+        // The accumulated response is (real + j.imag) / denominator, denominator being real and positive
+        if (output.magnitudes != nullptr)
+            for (int i = 0; i < numPoints; ++i)
+                output.magnitudes[start + i] = std::sqrt(real[i] * real[i] + imag[i] * imag[i]) / denominator[i];
+
+        if (output.phases != nullptr)
+            for (int i = 0; i < numPoints; ++i)
+                output.phases[start + i] = std::atan2(imag[i], real[i]);
+
+        if (output.groupDelays != nullptr)
+            for (int i = 0; i < numPoints; ++i)
+                output.groupDelays[start + i] = groupDelay[i];
+    }
+}
+
+void computeFrequencyResponse(const ChainCoefficients& chainCoefficients,
+                              const double* frequencies, int numFrequencies, double sampleRate,
+                              const FrequencyResponseOutput& output) noexcept
+{
+    const auto active = getActiveSections(chainCoefficients);
+
+    std::array<BiquadCoefficients, maxNumChainSections> sections;
+    auto numSections = 0;
+
+    for (int i = 0; i < active.lowCut; ++i)
+        sections[(size_t) numSections++] = chainCoefficients.lowCut[(size_t) i];
+
+    for (size_t i = 0; i < chainCoefficients.bands.size(); ++i)
+        if (chainCoefficients.bandActive[i])
+            sections[(size_t) numSections++] = chainCoefficients.bands[i];
+
+    for (int i = 0; i < active.highCut; ++i)
+        sections[(size_t) numSections++] = chainCoefficients.highCut[(size_t) i];
+
+    computeFrequencyResponse(sections.data(), numSections, frequencies, numFrequencies, sampleRate, output);
+}
+
+void computeFrequencyResponse(const ChainSettings& chainSettings,
+                              const double* frequencies, int numFrequencies, double sampleRate,
+                              const FrequencyResponseOutput& output) noexcept
+{
+    computeFrequencyResponse(makeChainCoefficients(chainSettings, sampleRate),
+                             frequencies, numFrequencies, sampleRate, output);
+}
+
+template<typename SampleType>
+void computeFrequencyResponse(const MonoChainType<SampleType>& chain,
+                              const double* frequencies, int numFrequencies, double sampleRate,
+                              const FrequencyResponseOutput& output) noexcept
+{
+    std::array<BiquadCoefficients, maxNumChainSections> sections;
+    auto numSections = 0;
+
+    // IIR::Coefficients keeps [b0, b1, b2, a1, a2] for a biquad, [b0, b1, a1] for a first order filter
+    auto addFilter = [&](const FilterType<SampleType>& filter)
+    {
+        if (filter.coefficients == nullptr)
+            return;
+
+        const auto& raw = filter.coefficients->coefficients;
+        auto& section = sections[(size_t) numSections];
+
+        if (raw.size() == 5)
+            section = { (float) raw[0], (float) raw[1], (float) raw[2], (float) raw[3], (float) raw[4] };
+        else if (raw.size() == 3)
+            section = { (float) raw[0], (float) raw[1], 0.0f, (float) raw[2], 0.0f };
+        else
+            return;
+
+        ++numSections;
+    };
+
+    auto addCutFilter = [&](const CutFilterType<SampleType>& cut)
+    {
+        if (! cut.template isBypassed<0>()) addFilter(cut.template get<0>());
+        if (! cut.template isBypassed<1>()) addFilter(cut.template get<1>());
+        if (! cut.template isBypassed<2>()) addFilter(cut.template get<2>());
+        if (! cut.template isBypassed<3>()) addFilter(cut.template get<3>());
+    };
+
+    addCutFilter(chain.template get<ChainPositions::LowCut>());
+
+    // The bands only hold the ones that run
+    if (! chain.template isBypassed<ChainPositions::Bands>())
+    {
+        const auto& bands = chain.template get<ChainPositions::Bands>();
+
+        for (int slot = 0; slot < bands.getNumActiveBands(); ++slot)
+            sections[(size_t) numSections++] = bands.getActiveBandCoefficients(slot);
+    }
+
+    addCutFilter(chain.template get<ChainPositions::HighCut>());
+
+    computeFrequencyResponse(sections.data(), numSections, frequencies, numFrequencies, sampleRate, output);
+}
+
+template void computeFrequencyResponse<float>(const MonoChainType<float>&, const double*, int, double, const FrequencyResponseOutput&) noexcept;
+template void computeFrequencyResponse<double>(const MonoChainType<double>&, const double*, int, double, const FrequencyResponseOutput&) noexcept;
@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    FrequencyResponse.h
+    Magnitude, phase and group delay of the chain at many frequencies in one call.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+//==============================================================================
+/**
+    Where computeFrequencyResponse() writes its results, one value per frequency.
+    Any of them can be null when it isn't needed.
+*/
+struct FrequencyResponseOutput
+{
+    double* magnitudes {nullptr};   // Linear gain
+    double* phases {nullptr};       // Radians, wrapped to [-pi, pi]
+    double* groupDelays {nullptr};  // Samples
+};
+
+// Response of a cascade of biquads at numFrequencies frequencies (Hz).
+//
+// The points are done in blocks: the sines and cosines of a block are computed once,
+// then every section runs over the whole block with branch-free loops the compiler
+// turns into SIMD instructions. The division of the sections is only done once per
+// point at the end, and no memory is allocated.
+void computeFrequencyResponse(const BiquadCoefficients* sections, int numSections,
+                              const double* frequencies, int numFrequencies, double sampleRate,
+                              const FrequencyResponseOutput& output) noexcept;
+
+// Same for a designed chain: only the sections the audio thread runs (active bands, slope)
+void computeFrequencyResponse(const ChainCoefficients& chainCoefficients,
+                              const double* frequencies, int numFrequencies, double sampleRate,
+                              const FrequencyResponseOutput& output) noexcept;
+
+// Same for the parameter values, designed the way the processor designs them
+void computeFrequencyResponse(const ChainSettings& chainSettings,
+                              const double* frequencies, int numFrequencies, double sampleRate,
+                              const FrequencyResponseOutput& output) noexcept;
+
+// Same for a chain's current coefficients, skipping the bypassed links
+template<typename SampleType>
+void computeFrequencyResponse(const MonoChainType<SampleType>& chain,
+                              const double* frequencies, int numFrequencies, double sampleRate,
+                              const FrequencyResponseOutput& output) noexcept;
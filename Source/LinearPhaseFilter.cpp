@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    LinearPhaseFilter.cpp
+    Linear phase version of the chain: an FIR with the same magnitude response,
+    run by a uniformly partitioned FFT convolution.
+
+  ==============================================================================
+*/
+
+#include "LinearPhaseFilter.h"
+#include "Tracer.h"
+#include "FrequencyResponse.h"
+
+//==============================================================================
+juce::StringArray LinearPhaseFilter::getFirLengthNames()
+{
+    juce::StringArray names;
+    
+    for (auto length : firLengths)
+        names.add(juce::String(length));
+    
+    return names;
+}
+
+void LinearPhaseFilter::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    numChannels = spec.numChannels;
+    convolutions.clear();
+    
+    for (size_t channel = 0; channel < numChannels; channel += 2)
+    {
+        auto convolution = std::make_unique<juce::dsp::Convolution>(juce::dsp::Convolution::Latency { partitionSize },
+                                                                    *messageQueue);
+        
+        auto pairSpec = spec;
+        pairSpec.numChannels = (juce::uint32) juce::jmin((size_t) 2, numChannels - channel);
+        convolution->prepare(pairSpec);
+        
+        convolutions.push_back(std::move(convolution));
+    }
+    
+    // New convolutions, they need an FIR
+    builtDesignNumber = 0;
+    builtFirLength = 0;
+    lastBuildTime = 0.0;
+    loadedFirLength = 0;
+}
+
+void LinearPhaseFilter::reset()
+{
+    for (auto& convolution : convolutions)
+        convolution->reset();
+}
+
+int LinearPhaseFilter::getLatencySamples(int numFirSamples) const noexcept
+{
+    // A power of 2 partition size is exactly the latency the convolution runs at. Not asking the
+    // convolutions themselves: their engines are swapped on the audio thread.
+    static_assert(juce::isPowerOfTwo(partitionSize), "The convolution rounds its latency up to a power of 2");
+    
+    return numFirSamples / 2 + partitionSize;
+}
+
+bool LinearPhaseFilter::isFirLoaded(int numFirSamples) const noexcept
+{
+    for (auto& convolution : convolutions)
+        if (convolution->getCurrentIRSize() != numFirSamples)
+            return false;
+    
+    return ! convolutions.empty();
+}
+
+void LinearPhaseFilter::process(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto blockChannels = juce::jmin(block.getNumChannels(), numChannels);
+    
+    // The convolutions only pick up a loaded FIR while they process: they run in any case
+    for (size_t channel = 0; channel < blockChannels; channel += 2)
+    {
+        auto pair = block.getSubsetChannelBlock(channel, juce::jmin((size_t) 2, blockChannels - channel));
+        juce::dsp::ProcessContextReplacing<float> context(pair);
+        
+        convolutions[channel / 2]->process(context);
+    }
+    
+    const auto length = firLength.load();
+    
+    if (length == loadedFirLength)
+        return;
+    
+    // Not the FIR the latency is reported for yet: nothing of this block goes out
+    if (isFirLoaded(length))
+    {
+        // Drops the crossfade from the previous impulse response, the next block starts clean
+        reset();
+        loadedFirLength = length;
+    }
+    
+    block.clear();
+}
+
+bool LinearPhaseFilter::waitUntilFirLoaded(int timeoutMilliseconds)
+{
+    if (convolutions.empty())
+        return false;
+    
+    // Silent blocks make the convolutions install the FIR once it is built, process() resets them then
+    juce::AudioBuffer<float> silence((int) numChannels, partitionSize);
+    const auto endTime = juce::Time::getMillisecondCounterHiRes() + timeoutMilliseconds;
+    
+    while (loadedFirLength != firLength.load())
+    {
+        if (juce::Time::getMillisecondCounterHiRes() > endTime)
+            return false;
+        
+        silence.clear();
+        process(juce::dsp::AudioBlock<float>(silence));
+        
+        juce::Thread::sleep(1);
+    }
+    
+    return true;
+}
+
+void LinearPhaseFilter::designImpulseResponse(const ChainCoefficients& chainCoefficients, double sampleRate,
+                                              juce::AudioBuffer<float>& impulseResponse)
+{
+    const auto length = impulseResponse.getNumSamples();
+    jassert(juce::isPowerOfTwo(length));
+    
+    // Magnitude on every bin, no phase: the inverse FFT gives a symmetric impulse centred on sample 0
+    std::vector<float> spectrum((size_t) length * 2, 0.0f);
+    
+    const auto numBins = length / 2 + 1;
+    std::vector<double> frequencies((size_t) numBins), magnitudes((size_t) numBins);
+    
+    for (int bin = 0; bin < numBins; ++bin)
+        frequencies[(size_t) bin] = sampleRate * bin / length;
+    
+    FrequencyResponseOutput output;
+    output.magnitudes = magnitudes.data();
+    computeFrequencyResponse(chainCoefficients, frequencies.data(), numBins, sampleRate, output);
+    
+    for (int bin = 0; bin < numBins; ++bin)
+        spectrum[(size_t) bin * 2] = (float) magnitudes[(size_t) bin];
+    
+    juce::dsp::FFT fft(juce::roundToInt(std::log2(length)));
+    fft.performRealOnlyInverseTransform(spectrum.data());
+    
+    // Move the centre to the middle of the FIR, then window it to smooth out the truncation
+    auto* fir = impulseResponse.getWritePointer(0);
+    
+    for (int n = 0; n < length; ++n)
+        fir[n] = spectrum[(size_t) ((n + length / 2) % length)];
+    
+    juce::dsp::WindowingFunction<float> window((size_t) length, juce::dsp::WindowingFunction<float>::blackmanHarris, false);
+    window.multiplyWithWindowingTable(fir, (size_t) length);
+}
+
+void LinearPhaseFilter::designAvailable(const ChainCoefficients& design, juce::uint32 designNumber, double sampleRate)
+{
+    // Mode off: nothing to build, the designer hands over the current design again on its next time slice
+    if (convolutions.empty() || ! enabled.load())
+        return;
+    
+    const auto length = firLength.load();
+    
+    if (designNumber == builtDesignNumber && length == builtFirLength)
+        return;
+    
+    // Too soon after the last one: the designer calls again on its next time slice
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    
+    if (now - lastBuildTime < minRebuildInterval)
+        return;
+    
+    const Tracer::ScopedEvent traceEvent("design FIR", length);
+    
+    juce::AudioBuffer<float> impulseResponse(1, length);
+    designImpulseResponse(design, sampleRate, impulseResponse);
+    
+    // Every convolution gets its own copy, they crossfade to it on the audio thread
+    for (auto& convolution : convolutions)
+    {
+        juce::AudioBuffer<float> copy(impulseResponse);
+        convolution->loadImpulseResponse(std::move(copy), sampleRate,
+                                         juce::dsp::Convolution::Stereo::no,
+                                         juce::dsp::Convolution::Trim::no,
+                                         juce::dsp::Convolution::Normalise::no);
+    }
+    
+    builtDesignNumber = designNumber;
+    builtFirLength = length;
+    lastBuildTime = now;
+}
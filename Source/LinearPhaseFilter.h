@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    LinearPhaseFilter.h
+    Linear phase version of the chain: an FIR with the same magnitude response,
+    run by a uniformly partitioned FFT convolution.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+#include "CoefficientDesigner.h"
+
+//==============================================================================
+/**
+    Mastering mode: the magnitude response of the Low cut / bands / High cut designs,
+    without their phase shift.
+ 
+    The FIR is derived from the magnitude of the current design (the same curve the
+    ResponseCurveComponent draws): the magnitude is sampled on the FFT bins, turned into
+    a zero phase impulse by an inverse FFT, centred and windowed. While the mode is on, it
+    is rebuilt on the background design thread whenever a new design is published, and
+    handed to juce::dsp::Convolution, which switches to it with a crossfade. While it is
+    off nothing is built: switching it on builds the FIR of the current design on the next
+    time slice of the designer.
+ 
+    Until the convolutions run an FIR of the length the latency is reported for (the first
+    one after prepare(), or after the length changed), the output is silent: the unit impulse
+    they start with, or an FIR of another length, would be unfiltered or misaligned audio.
+ 
+    The convolution is uniformly partitioned in blocks of partitionSize samples, so its
+    cost per sample stays the same at 64 sample buffers. The latency is half the FIR
+    (where its peak sits) plus one partition.
+*/
+class LinearPhaseFilter : public CoefficientDesigner::Listener
+{
+public:
+    // Size of the partitions of the convolution, which is also its own latency
+    static constexpr int partitionSize = 64;
+    
+    // FIR lengths offered by the "FIR Length" parameter: longer is more accurate in the low end, and costs more
+    static constexpr std::array<int, 5> firLengths { 1024, 2048, 4096, 8192, 16384 };
+    static constexpr int defaultFirLengthIndex = 2;
+    
+    static juce::StringArray getFirLengthNames();
+    
+    LinearPhaseFilter() = default;
+    
+    // Creates one convolution per pair of channels. Not to be called while the designer is running.
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    
+    // Clears the convolution states (the FIR is kept)
+    void reset();
+    
+    // Length of the FIR to build, one of firLengths. Safe from any thread.
+    void setFirLength(int numSamples) noexcept { firLength = numSamples; }
+    int getFirLength() const noexcept { return firLength.load(); }
+    
+    // FIRs are only built while the linear phase mode is on. Safe from any thread.
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled = shouldBeEnabled; }
+    
+    // Delay introduced by the filter with an FIR of the given length. Safe from any thread.
+    int getLatencySamples(int numFirSamples) const noexcept;
+    
+    // Filters the block in place, at most the number of channels it was prepared with.
+    // Silent until the FIR of the current length is loaded.
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept;
+    
+    // Blocks until the FIR of the current length is loaded and the convolutions are clean, so
+    // the first block is already filtered. For offline rendering, not for the audio thread.
+    // Returns false if it took longer than the timeout.
+    bool waitUntilFirLoaded(int timeoutMilliseconds);
+    
+    // Zero phase FIR with the magnitude response of the chain, delayed by half its length.
+    // The length of the buffer is the length of the FIR (a power of 2).
+    static void designImpulseResponse(const ChainCoefficients& chainCoefficients, double sampleRate,
+                                      juce::AudioBuffer<float>& impulseResponse);
+    
+private:
+    // Background thread: rebuilds the FIR when the design or its length changed, if enabled
+    void designAvailable(const ChainCoefficients& design, juce::uint32 designNumber, double sampleRate) override;
+    
+    // Background thread loading the impulse responses into the convolutions. One for every instance
+    // of the plug-in, like the design thread: a session full of instances doesn't get a thread each.
+    juce::SharedResourcePointer<juce::dsp::ConvolutionMessageQueue> messageQueue;
+    
+    // juce::dsp::Convolution processes up to 2 channels
+    std::vector<std::unique_ptr<juce::dsp::Convolution>> convolutions;
+    
+    size_t numChannels {0};
+    
+    std::atomic<int> firLength {firLengths[defaultFirLengthIndex]};
+    std::atomic<bool> enabled {false};
+    
+    // Audio thread: length of the FIR the convolutions run, 0 until the first one is loaded
+    int loadedFirLength {0};
+    
+    // True if every convolution runs an FIR of numFirSamples samples
+    bool isFirLoaded(int numFirSamples) const noexcept;
+    
+    // Only touched by the design thread (or prepare() while it is stopped)
+    juce::uint32 builtDesignNumber {0};
+    int builtFirLength {0};
+    double lastBuildTime {0.0};
+    
+    // While parameters move, FIRs are built at most this often (ms), the crossfade covers the steps
+    static constexpr double minRebuildInterval = 30.0;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LinearPhaseFilter)
+};
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    LoadMeter.h
+    Time spent in processBlock, measured on the audio thread and read by the editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// On by default. Build with SIMPLYQUEUE_LOAD_METER=0 and processBlock has no timing code
+// at all, and the editor doesn't show the meter.
+#ifndef SIMPLYQUEUE_LOAD_METER
+ #define SIMPLYQUEUE_LOAD_METER 1
+#endif
+
+#if SIMPLYQUEUE_LOAD_METER
+
+//==============================================================================
+/**
+    Per block timings, handed from the audio thread to the editor through a lock-free
+    single producer / single consumer FIFO.
+
+    Nothing is timed while no editor is reading: the audio thread only checks one
+    atomic flag per block. When the FIFO is full (the editor is busy), measurements
+    are dropped instead of waiting.
+*/
+class LoadMeter
+{
+public:
+    // Seconds spent in each part of one processBlock call, and the time the block lasts in real time
+    struct Measurement
+    {
+        double coefficientUpdate { 0.0 };
+        double filterProcessing { 0.0 };
+        double budget { 0.0 };
+
+        double getLoad() const noexcept { return budget > 0.0 ? (coefficientUpdate + filterProcessing) / budget : 0.0; }
+    };
+
+    //==============================================================================
+    // Audio thread side
+
+    void prepare(double newSampleRate) noexcept { sampleRate = newSampleRate; }
+
+    bool isReading() const noexcept { return reading.load(std::memory_order_relaxed); }
+
+    void push(const Measurement& measurement) noexcept
+    {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 > 0)
+            measurements[(size_t) scope.startIndex1] = measurement;
+    }
+
+    //==============================================================================
+    // Editor side
+
+    // Timing starts with the next block once a reader is there
+    void setReading(bool shouldRead) noexcept
+    {
+        // What is left from the last time the meter was shown is out of date
+        if (shouldRead)
+            fifo.finishedRead(fifo.getNumReady());
+
+        reading.store(shouldRead, std::memory_order_relaxed);
+    }
+
+    // Calls the function with every measurement pushed since the last call
+    template<typename Function>
+    void pull(Function&& function)
+    {
+        const auto scope = fifo.read(fifo.getNumReady());
+        scope.forEach([&](int index) { function(measurements[(size_t) index]); });
+    }
+
+    //==============================================================================
+    /**
+        Times one processBlock call. Every lap adds the time since the previous one to
+        one of the two parts, the measurement is pushed when the timer goes out of scope
+        (early returns included).
+    */
+    class BlockTimer
+    {
+    public:
+        BlockTimer(LoadMeter& loadMeter, int numSamples) noexcept
+            : meter(loadMeter),
+              enabled(loadMeter.isReading()),
+              lastTicks(enabled ? juce::Time::getHighResolutionTicks() : 0)
+        {
+            if (enabled && meter.sampleRate > 0.0)
+                measurement.budget = numSamples / meter.sampleRate;
+        }
+
+        ~BlockTimer()
+        {
+            if (enabled)
+                meter.push(measurement);
+        }
+
+        void lapCoefficientUpdate() noexcept  { if (enabled) measurement.coefficientUpdate += lap(); }
+        void lapFilterProcessing() noexcept   { if (enabled) measurement.filterProcessing += lap(); }
+
+    private:
+        double lap() noexcept
+        {
+            const auto ticks = juce::Time::getHighResolutionTicks();
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(ticks - lastTicks);
+            lastTicks = ticks;
+            return seconds;
+        }
+
+        LoadMeter& meter;
+        const bool enabled;
+        juce::int64 lastTicks;
+        Measurement measurement;
+
+        JUCE_DECLARE_NON_COPYABLE(BlockTimer)
+    };
+
+private:
+    static constexpr int fifoSize = 512;
+
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<Measurement, fifoSize> measurements;
+
+    std::atomic<bool> reading { false };
+    double sampleRate { 0.0 };
+};
+
+#else
+
+// Compiled out: the same interface, doing nothing, so processBlock doesn't need any #if
+class LoadMeter
+{
+public:
+    void prepare(double) noexcept {}
+
+    class BlockTimer
+    {
+    public:
+        BlockTimer(LoadMeter&, int) noexcept {}
+
+        void lapCoefficientUpdate() noexcept {}
+        void lapFilterProcessing() noexcept {}
+    };
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    Parameters.cpp
+    Table of every parameter of the plugin, and their values read by index.
+
+  ==============================================================================
+*/
+
+#include "Parameters.h"
+#include "LinearPhaseFilter.h"
+
+static_assert((int) parameterTable[FirLength].defaultValue == LinearPhaseFilter::defaultFirLengthIndex,
+              "The default FIR length of the table and of LinearPhaseFilter must be the same");
+
+//==============================================================================
+juce::StringArray getChoiceNames(ChoiceList choices)
+{
+    switch (choices)
+    {
+        case ChoiceList::Slopes:
+        {
+            juce::StringArray dbStringArray;
+            for (int i = 0; i < 4; i++)
+            {
+                juce::String str;
+                str << (12 + i*12);
+                str << "db/Oct";
+                dbStringArray.add(str);
+            }
+            return dbStringArray;
+        }
+
+        case ChoiceList::FirLengths:
+            return LinearPhaseFilter::getFirLengthNames();
+
+        // In the order of BandType
+        case ChoiceList::BandTypes:
+            return { "Peak", "Low Shelf", "High Shelf", "Notch" };
+
+        case ChoiceList::None:
+            break;
+    }
+
+    return {};
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayoutFromTable()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    for (const auto& parameter : parameterTable)
+    {
+        switch (parameter.type)
+        {
+            case ParameterType::Float:
+                layout.add(std::make_unique<juce::AudioParameterFloat>(parameter.id, parameter.id,
+                                                                       juce::NormalisableRange<float>(parameter.minimum, parameter.maximum,
+                                                                                                      parameter.interval, parameter.skew),
+                                                                       parameter.defaultValue));
+                break;
+
+            case ParameterType::Choice:
+                layout.add(std::make_unique<juce::AudioParameterChoice>(parameter.id, parameter.id, getChoiceNames(parameter.choices),
+                                                                        (int) parameter.defaultValue));
+                break;
+
+            case ParameterType::Bool:
+                layout.add(std::make_unique<juce::AudioParameterBool>(parameter.id, parameter.id, parameter.defaultValue > 0.5f));
+                break;
+        }
+    }
+
+    return layout;
+}
+
+//==============================================================================
+ParameterValues::ParameterValues(juce::AudioProcessorValueTreeState& apvts)
+{
+    for (const auto& parameter : parameterTable)
+    {
+        values[(size_t) parameter.index] = apvts.getRawParameterValue(parameter.id);
+
+        // Every line of the table has to be in the layout
+        jassert(values[(size_t) parameter.index] != nullptr);
+    }
+}
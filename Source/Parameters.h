@@ -0,0 +1,242 @@
+/*
+  ==============================================================================
+
+    Parameters.h
+    Table of every parameter of the plugin, and their values read by index.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Number of parametric bands between the cuts (peak, shelves or notch, see BandType)
+constexpr int maxNumBands = 8;
+
+// Every parameter, in the order the host sees them. Index into parameterTable and ParameterValues.
+enum ParameterIndex
+{
+    LowCutFreq,
+    HighCutFreq,
+    PeakFreq,
+    PeakGain,
+    PeakQ,
+    LowCutSlope,
+    HighCutSlope,
+    LinearPhase,
+    FirLength,
+
+    // Band 1 is the peak above, its type and its switch came with the other bands
+    PeakType,
+    PeakOn,
+
+    Band2Freq,
+    Band2Gain,
+    Band2Q,
+    Band2Type,
+    Band2On,
+
+    Band3Freq,
+    Band3Gain,
+    Band3Q,
+    Band3Type,
+    Band3On,
+
+    Band4Freq,
+    Band4Gain,
+    Band4Q,
+    Band4Type,
+    Band4On,
+
+    Band5Freq,
+    Band5Gain,
+    Band5Q,
+    Band5Type,
+    Band5On,
+
+    Band6Freq,
+    Band6Gain,
+    Band6Q,
+    Band6Type,
+    Band6On,
+
+    Band7Freq,
+    Band7Gain,
+    Band7Q,
+    Band7Type,
+    Band7On,
+
+    Band8Freq,
+    Band8Gain,
+    Band8Q,
+    Band8Type,
+    Band8On,
+
+    NumParameters
+};
+
+enum class ParameterType
+{
+    Float,
+    Choice,
+    Bool
+};
+
+// Option lists of the choice parameters, built by getChoiceNames()
+enum class ChoiceList
+{
+    None,
+    Slopes,
+    FirLengths,
+    BandTypes
+};
+
+// Everything createParameterLayout() needs to build one parameter
+struct ParameterDescriptor
+{
+    ParameterIndex index;
+    const char* id;             // Also the name shown by the host. Saved in the sessions: never rename one.
+    ParameterType type;
+
+    float minimum, maximum;     // Range of a float parameter
+    float interval, skew;
+
+    float defaultValue;         // Value of a float, option index of a choice, 0 or 1 for a bool
+    ChoiceList choices;
+};
+
+// -------------------------------------------------------------------------------------------------------
+// Adding a parameter: a value in ParameterIndex and a line here. The layout, the state, the cached values
+// and the attachments all come from this table.
+// -------------------------------------------------------------------------------------------------------
+inline constexpr std::array<ParameterDescriptor, NumParameters> parameterTable
+{{
+    { LowCutFreq,   "Low-Cut Freq",   ParameterType::Float,  20.0f, 20000.0f, 1.0f,  0.25f, 20.0f,    ChoiceList::None },
+    { HighCutFreq,  "High-Cut Freq",  ParameterType::Float,  20.0f, 20000.0f, 1.0f,  0.25f, 20000.0f, ChoiceList::None },
+    { PeakFreq,     "Peak Freq",      ParameterType::Float,  20.0f, 20000.0f, 1.0f,  0.25f, 750.0f,   ChoiceList::None },
+
+    // Interval 0.5 = change of half of a decibel
+    { PeakGain,     "Peak Gain",      ParameterType::Float, -24.0f, 24.0f,    0.5f,  1.0f,  0.0f,     ChoiceList::None },
+    { PeakQ,        "Peak Q",         ParameterType::Float,  0.1f,  10.0f,    0.05f, 1.0f,  1.0f,     ChoiceList::None },
+
+    // Choice of slopes for the HPF and the LPF (see SlopeSettings)
+    { LowCutSlope,  "Low-Cut Slope",  ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::Slopes },
+    { HighCutSlope, "High-Cut Slope", ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::Slopes },
+
+    // Linear phase mode (mastering): same magnitude response from an FIR, at the cost of latency
+    { LinearPhase,  "Linear Phase",   ParameterType::Bool,   0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::None },
+
+    // Length of that FIR: longer is more accurate in the low end, costs more CPU and latency.
+    // Defaults to LinearPhaseFilter::defaultFirLengthIndex (checked in Parameters.cpp).
+    { FirLength,    "FIR Length",     ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  2.0f,     ChoiceList::FirLengths },
+
+    // Type (see BandType) and switch of band 1. On by default: sessions saved before the other
+    // bands existed sound the same.
+    { PeakType,     "Peak Type",      ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::BandTypes },
+    { PeakOn,       "Peak On",        ParameterType::Bool,   0.0f,  0.0f,     0.0f,  1.0f,  1.0f,     ChoiceList::None },
+
+    // Bands 2 to 8, off until switched on
+    { Band2Freq,    "Band 2 Freq",    ParameterType::Float,  20.0f, 20000.0f, 1.0f,  0.25f, 60.0f,    ChoiceList::None },
+    { Band2Gain,    "Band 2 Gain",    ParameterType::Float, -24.0f, 24.0f,    0.5f,  1.0f,  0.0f,     ChoiceList::None },
+    { Band2Q,       "Band 2 Q",       ParameterType::Float,  0.1f,  10.0f,    0.05f, 1.0f,  1.0f,     ChoiceList::None },
+    { Band2Type,    "Band 2 Type",    ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::BandTypes },
+    { Band2On,      "Band 2 On",      ParameterType::Bool,   0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::None },
+
+    { Band3Freq,    "Band 3 Freq",    ParameterType::Float,  20.0f, 20000.0f, 1.0f,  0.25f, 150.0f,   ChoiceList::None },
+    { Band3Gain,    "Band 3 Gain",    ParameterType::Float, -24.0f, 24.0f,    0.5f,  1.0f,  0.0f,     ChoiceList::None },
+    { Band3Q,       "Band 3 Q",       ParameterType::Float,  0.1f,  10.0f,    0.05f, 1.0f,  1.0f,     ChoiceList::None },
+    { Band3Type,    "Band 3 Type",    ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::BandTypes },
+    { Band3On,      "Band 3 On",      ParameterType::Bool,   0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::None },
+
+    { Band4Freq,    "Band 4 Freq",    ParameterType::Float,  20.0f, 20000.0f, 1.0f,  0.25f, 400.0f,   ChoiceList::None },
+    { Band4Gain,    "Band 4 Gain",    ParameterType::Float, -24.0f, 24.0f,    0.5f,  1.0f,  0.0f,     ChoiceList::None },
+    { Band4Q,       "Band 4 Q",       ParameterType::Float,  0.1f,  10.0f,    0.05f, 1.0f,  1.0f,     ChoiceList::None },
+    { Band4Type,    "Band 4 Type",    ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::BandTypes },
+    { Band4On,      "Band 4 On",      ParameterType::Bool,   0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::None },
+
+    { Band5Freq,    "Band 5 Freq",    ParameterType::Float,  20.0f, 20000.0f, 1.0f,  0.25f, 1500.0f,  ChoiceList::None },
+    { Band5Gain,    "Band 5 Gain",    ParameterType::Float, -24.0f, 24.0f,    0.5f,  1.0f,  0.0f,     ChoiceList::None },
+    { Band5Q,       "Band 5 Q",       ParameterType::Float,  0.1f,  10.0f,    0.05f, 1.0f,  1.0f,     ChoiceList::None },
+    { Band5Type,    "Band 5 Type",    ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::BandTypes },
+    { Band5On,      "Band 5 On",      ParameterType::Bool,   0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::None },
+
+    { Band6Freq,    "Band 6 Freq",    ParameterType::Float,  20.0f, 20000.0f, 1.0f,  0.25f, 3000.0f,  ChoiceList::None },
+    { Band6Gain,    "Band 6 Gain",    ParameterType::Float, -24.0f, 24.0f,    0.5f,  1.0f,  0.0f,     ChoiceList::None },
+    { Band6Q,       "Band 6 Q",       ParameterType::Float,  0.1f,  10.0f,    0.05f, 1.0f,  1.0f,     ChoiceList::None },
+    { Band6Type,    "Band 6 Type",    ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::BandTypes },
+    { Band6On,      "Band 6 On",      ParameterType::Bool,   0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::None },
+
+    { Band7Freq,    "Band 7 Freq",    ParameterType::Float,  20.0f, 20000.0f, 1.0f,  0.25f, 6000.0f,  ChoiceList::None },
+    { Band7Gain,    "Band 7 Gain",    ParameterType::Float, -24.0f, 24.0f,    0.5f,  1.0f,  0.0f,     ChoiceList::None },
+    { Band7Q,       "Band 7 Q",       ParameterType::Float,  0.1f,  10.0f,    0.05f, 1.0f,  1.0f,     ChoiceList::None },
+    { Band7Type,    "Band 7 Type",    ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::BandTypes },
+    { Band7On,      "Band 7 On",      ParameterType::Bool,   0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::None },
+
+    { Band8Freq,    "Band 8 Freq",    ParameterType::Float,  20.0f, 20000.0f, 1.0f,  0.25f, 12000.0f, ChoiceList::None },
+    { Band8Gain,    "Band 8 Gain",    ParameterType::Float, -24.0f, 24.0f,    0.5f,  1.0f,  0.0f,     ChoiceList::None },
+    { Band8Q,       "Band 8 Q",       ParameterType::Float,  0.1f,  10.0f,    0.05f, 1.0f,  1.0f,     ChoiceList::None },
+    { Band8Type,    "Band 8 Type",    ParameterType::Choice, 0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::BandTypes },
+    { Band8On,      "Band 8 On",      ParameterType::Bool,   0.0f,  0.0f,     0.0f,  1.0f,  0.0f,     ChoiceList::None },
+}};
+
+// A line out of place would silently swap two parameters
+constexpr bool isParameterTableInOrder()
+{
+    for (size_t i = 0; i < parameterTable.size(); ++i)
+        if (parameterTable[i].index != (ParameterIndex) i)
+            return false;
+
+    return true;
+}
+
+static_assert(isParameterTableInOrder(), "parameterTable must follow the order of ParameterIndex");
+
+inline const char* getParameterId(ParameterIndex index) noexcept { return parameterTable[(size_t) index].id; }
+
+// The parameters of one parametric band
+struct BandParameterIndices
+{
+    ParameterIndex freq, gain, quality, type, enabled;
+};
+
+// Band 1 first. It is the original peak, so its parameters are not next to each other in the table.
+inline constexpr std::array<BandParameterIndices, maxNumBands> bandParameterTable
+{{
+    { PeakFreq, PeakGain, PeakQ, PeakType, PeakOn },
+    { Band2Freq, Band2Gain, Band2Q, Band2Type, Band2On },
+    { Band3Freq, Band3Gain, Band3Q, Band3Type, Band3On },
+    { Band4Freq, Band4Gain, Band4Q, Band4Type, Band4On },
+    { Band5Freq, Band5Gain, Band5Q, Band5Type, Band5On },
+    { Band6Freq, Band6Gain, Band6Q, Band6Type, Band6On },
+    { Band7Freq, Band7Gain, Band7Q, Band7Type, Band7On },
+    { Band8Freq, Band8Gain, Band8Q, Band8Type, Band8On },
+}};
+
+// Names of the options of a choice parameter
+juce::StringArray getChoiceNames(ChoiceList choices);
+
+// The parameters of the apvts, built from the table
+juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayoutFromTable();
+
+//==============================================================================
+/**
+    The value of every parameter, looked up by ID once at construction, then read by
+    index: no string comparison, no map lookup. Safe to read from any thread.
+*/
+class ParameterValues
+{
+public:
+    explicit ParameterValues(juce::AudioProcessorValueTreeState& apvts);
+
+    // Value in the parameter's range (not normalised)
+    float get(ParameterIndex index) const noexcept { return values[(size_t) index]->load(std::memory_order_relaxed); }
+
+    // Option index of a choice parameter
+    int getChoice(ParameterIndex index) const noexcept { return (int) get(index); }
+
+    bool getBool(ParameterIndex index) const noexcept { return get(index) > 0.5f; }
+
+private:
+    std::array<std::atomic<float>*, NumParameters> values;
+};
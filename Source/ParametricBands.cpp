@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    ParametricBands.cpp
+    The parametric bands between the cuts: up to maxNumBands biquads, only the enabled ones run.
+
+  ==============================================================================
+*/
+
+#include "ParametricBands.h"
+
+//==============================================================================
+template<typename SampleType>
+void ParametricBands<SampleType>::prepare(const juce::dsp::ProcessSpec& spec) noexcept
+{
+    // Everything is in fixed size arrays: nothing to allocate
+    jassert(spec.numChannels == 1);
+    juce::ignoreUnused(spec);
+
+    reset();
+}
+
+template<typename SampleType>
+void ParametricBands<SampleType>::reset() noexcept
+{
+    state = {};
+}
+
+template<typename SampleType>
+void ParametricBands<SampleType>::setCoefficients(const BandCoefficients& coefficients, const BandMask& active) noexcept
+{
+    setBandCascadeCoefficients(cascade, coefficients, active);
+    clearStoppedBands(state, active);
+}
+
+template<typename SampleType>
+BiquadCoefficients ParametricBands<SampleType>::getActiveBandCoefficients(int slot) const noexcept
+{
+    jassert(slot >= 0 && slot < cascade.numActive);
+    const auto i = (size_t) slot;
+
+    // The designs are single precision: narrowing a widened value back is exact
+    return { (float) cascade.b0[i], (float) cascade.b1[i], (float) cascade.b2[i],
+             (float) cascade.a1[i], (float) cascade.a2[i] };
+}
+
+// The chains only come in float and double
+template class ParametricBands<float>;
+template class ParametricBands<double>;
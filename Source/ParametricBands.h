@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    ParametricBands.h
+    The parametric bands between the cuts: up to maxNumBands biquads, only the enabled ones run.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BiquadDesign.h"
+#include "Parameters.h"
+
+// One biquad per band, in band order, and which of them run
+using BandCoefficients = std::array<BiquadCoefficients, maxNumBands>;
+using BandMask = std::array<bool, maxNumBands>;
+
+// A designed (float) coefficient in the sample type of a cascade: widened for double, copied in
+// every lane for a SIMD register
+template<typename SampleType>
+inline SampleType toSampleType(float value) noexcept
+{
+    if constexpr (std::is_floating_point_v<SampleType>)
+        return static_cast<SampleType>(value);
+    else
+        return SampleType::expand(static_cast<typename SampleType::ElementType>(value));
+}
+
+// -------------------------------------------------------------------------------------------------------
+// Structure of arrays: one array per coefficient, slot i holding the i-th running band. The cascade walks
+// the first numActive slots of each array, a band that is switched off costs nothing at all.
+// SampleType is float, double or a SIMD register of either (one channel per lane).
+// -------------------------------------------------------------------------------------------------------
+template<typename SampleType>
+struct BandCascadeCoefficients
+{
+    std::array<SampleType, maxNumBands> b0 {}, b1 {}, b2 {}, a1 {}, a2 {};
+
+    std::array<int, maxNumBands> band {};   // Band running in each slot
+    int numActive {0};
+};
+
+// Transposed direct form II state of every band, indexed by band (not by slot): switching a band on or
+// off leaves the state of the others where it is
+template<typename SampleType>
+struct BandCascadeState
+{
+    std::array<SampleType, maxNumBands> lv1 {}, lv2 {};
+};
+
+// Packs the running bands into the slots, in band order
+template<typename SampleType>
+void setBandCascadeCoefficients(BandCascadeCoefficients<SampleType>& cascade,
+                                const BandCoefficients& coefficients, const BandMask& active) noexcept
+{
+    cascade.numActive = 0;
+
+    for (int band = 0; band < maxNumBands; ++band)
+    {
+        if (! active[(size_t) band])
+            continue;
+
+        const auto slot = (size_t) cascade.numActive++;
+        const auto& c = coefficients[(size_t) band];
+
+        cascade.b0[slot] = toSampleType<SampleType>(c.b0);
+        cascade.b1[slot] = toSampleType<SampleType>(c.b1);
+        cascade.b2[slot] = toSampleType<SampleType>(c.b2);
+        cascade.a1[slot] = toSampleType<SampleType>(c.a1);
+        cascade.a2[slot] = toSampleType<SampleType>(c.a2);
+        cascade.band[slot] = band;
+    }
+}
+
+// The bands that don't run keep a clean state, so they start from silence when they come back
+template<typename SampleType>
+void clearStoppedBands(BandCascadeState<SampleType>& state, const BandMask& active) noexcept
+{
+    for (size_t band = 0; band < (size_t) maxNumBands; ++band)
+    {
+        if (! active[band])
+        {
+            state.lv1[band] = {};
+            state.lv2[band] = {};
+        }
+    }
+}
+
+// Calls function(std::integral_constant<int, N>) with N = numBands (0 to maxNumBands)
+template<typename Function>
+void withNumBands(int numBands, Function&& function)
+{
+    jassert(numBands >= 0 && numBands <= maxNumBands);
+    static_assert(maxNumBands == 8, "One case per number of bands");
+
+    switch (numBands)
+    {
+        case 0:  function(std::integral_constant<int, 0>{}); break;
+        case 1:  function(std::integral_constant<int, 1>{}); break;
+        case 2:  function(std::integral_constant<int, 2>{}); break;
+        case 3:  function(std::integral_constant<int, 3>{}); break;
+        case 4:  function(std::integral_constant<int, 4>{}); break;
+        case 5:  function(std::integral_constant<int, 5>{}); break;
+        case 6:  function(std::integral_constant<int, 6>{}); break;
+        case 7:  function(std::integral_constant<int, 7>{}); break;
+        default: function(std::integral_constant<int, 8>{}); break;
+    }
+}
+
+// Runs the NumActive first slots over the samples (or interleaved frames) in place. The trip count is a
+// constant: the loop over the bands unrolls, and the coefficients and states are copied into locals so
+// they can stay in registers for the whole block. Same arithmetic, in the same order, as
+// juce::dsp::IIR::Filter.
+template<int NumActive, typename SampleType>
+void processBandCascade(SampleType* samples, size_t numSamples,
+                        const BandCascadeCoefficients<SampleType>& cascade,
+                        BandCascadeState<SampleType>& state) noexcept
+{
+    static_assert(NumActive >= 0 && NumActive <= maxNumBands, "There are maxNumBands bands at most");
+
+    if constexpr (NumActive > 0)
+    {
+        jassert(cascade.numActive == NumActive);
+
+        SampleType b0[NumActive], b1[NumActive], b2[NumActive], a1[NumActive], a2[NumActive];
+        SampleType lv1[NumActive], lv2[NumActive];
+
+        for (size_t slot = 0; slot < (size_t) NumActive; ++slot)
+        {
+            b0[slot] = cascade.b0[slot];
+            b1[slot] = cascade.b1[slot];
+            b2[slot] = cascade.b2[slot];
+            a1[slot] = cascade.a1[slot];
+            a2[slot] = cascade.a2[slot];
+
+            const auto band = (size_t) cascade.band[slot];
+            lv1[slot] = state.lv1[band];
+            lv2[slot] = state.lv2[band];
+        }
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            auto sample = samples[n];
+
+            for (size_t slot = 0; slot < (size_t) NumActive; ++slot)
+            {
+                const auto output = sample * b0[slot] + lv1[slot];
+                lv1[slot] = (sample * b1[slot]) - (output * a1[slot]) + lv2[slot];
+                lv2[slot] = (sample * b2[slot]) - (output * a2[slot]);
+                sample = output;
+            }
+
+            samples[n] = sample;
+        }
+
+        for (size_t slot = 0; slot < (size_t) NumActive; ++slot)
+        {
+            const auto band = (size_t) cascade.band[slot];
+            state.lv1[band] = lv1[slot];
+            state.lv2[band] = lv2[slot];
+        }
+    }
+    else
+    {
+        juce::ignoreUnused(samples, numSamples, cascade, state);
+    }
+}
+
+//==============================================================================
+/**
+    The bands of one channel, as a link of a juce::dsp::ProcessorChain (the middle of a MonoChain).
+
+    prepare(), reset() and process() work like a juce::dsp::IIR::Filter's, for a single channel.
+    setCoefficients() never allocates, so it can be called from the audio thread.
+*/
+template<typename SampleType>
+class ParametricBands
+{
+public:
+    ParametricBands() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) noexcept;
+    void reset() noexcept;
+
+    // Copies a designed set of bands. The ones that were not running start from a clean state.
+    void setCoefficients(const BandCoefficients& coefficients, const BandMask& active) noexcept;
+
+    int getNumActiveBands() const noexcept { return cascade.numActive; }
+
+    // Coefficients of the slot-th running band (0 to getNumActiveBands() - 1)
+    BiquadCoefficients getActiveBandCoefficients(int slot) const noexcept;
+
+    template<typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+
+        jassert(inputBlock.getNumChannels() == 1 && outputBlock.getNumChannels() == 1);
+
+        if (context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom(inputBlock);
+
+        if (context.isBypassed)
+            return;
+
+        withNumBands(cascade.numActive, [&](auto numBands)
+        {
+            processBandCascade<decltype(numBands)::value>(outputBlock.getChannelPointer(0), outputBlock.getNumSamples(),
+                                                          cascade, state);
+        });
+    }
+
+private:
+    BandCascadeCoefficients<SampleType> cascade;
+    BandCascadeState<SampleType> state;
+};
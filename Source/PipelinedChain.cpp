@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    PipelinedChain.cpp
+    Low cut --> Parametric bands --> High cut cascade of one channel at a time, consecutive sections in different SIMD lanes.
+
+  ==============================================================================
+*/
+
+#include "PipelinedChain.h"
+
+//==============================================================================
+template<typename FloatType>
+void PipelinedChain<FloatType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    jassert(spec.numChannels > 0 && spec.numChannels <= maxNumChannels);
+
+    states.resize(juce::jmin((size_t) spec.numChannels, maxNumChannels));
+
+    reset();
+}
+
+template<typename FloatType>
+void PipelinedChain<FloatType>::reset() noexcept
+{
+    for (auto& state : states)
+        state = {};
+}
+
+template<typename FloatType>
+int PipelinedChain<FloatType>::getSectionIndex(ChainPositions position, int i) noexcept
+{
+    switch (position)
+    {
+        case LowCut:  return i;
+        case Bands:   return 4 + i;
+        case HighCut: return 4 + maxNumBands + i;
+    }
+
+    return 0;
+}
+
+template<typename FloatType>
+void PipelinedChain<FloatType>::setCoefficients(const ChainCoefficients& chainCoefficients) noexcept
+{
+    Cascade newCascade;
+
+    auto addSection = [&](ChainPositions position, int i, const BiquadCoefficients& c)
+    {
+        const auto slot = (size_t) newCascade.numActive++;
+
+        newCascade.b0[slot] = static_cast<FloatType>(c.b0);
+        newCascade.b1[slot] = static_cast<FloatType>(c.b1);
+        newCascade.b2[slot] = static_cast<FloatType>(c.b2);
+        newCascade.a1[slot] = static_cast<FloatType>(c.a1);
+        newCascade.a2[slot] = static_cast<FloatType>(c.a2);
+        newCascade.section[slot] = getSectionIndex(position, i);
+    };
+
+    const auto sections = getActiveSections(chainCoefficients);
+
+    for (int i = 0; i < sections.lowCut; ++i)
+        addSection(LowCut, i, chainCoefficients.lowCut[(size_t) i]);
+
+    for (int band = 0; band < maxNumBands; ++band)
+        if (chainCoefficients.bandActive[(size_t) band])
+            addSection(Bands, band, chainCoefficients.bands[(size_t) band]);
+
+    for (int i = 0; i < sections.highCut; ++i)
+        addSection(HighCut, i, chainCoefficients.highCut[(size_t) i]);
+
+    // Sections came or went: every state follows its section to its new slot, the ones that were
+    // not running start from silence. Only when the sections change, not on every smoothing step.
+    const auto sameSections = newCascade.numActive == cascade.numActive
+                           && std::equal(newCascade.section.begin(), newCascade.section.begin() + newCascade.numActive,
+                                         cascade.section.begin());
+
+    if (! sameSections)
+    {
+        for (auto& state : states)
+        {
+            const auto previous = state;
+            state = {};
+
+            for (size_t slot = 0; slot < (size_t) newCascade.numActive; ++slot)
+            {
+                for (size_t oldSlot = 0; oldSlot < (size_t) cascade.numActive; ++oldSlot)
+                {
+                    if (cascade.section[oldSlot] == newCascade.section[slot])
+                    {
+                        state.lv1[slot] = previous.lv1[oldSlot];
+                        state.lv2[slot] = previous.lv2[oldSlot];
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    cascade = newCascade;
+}
+
+template<typename FloatType>
+template<int NumSections>
+void PipelinedChain<FloatType>::processGroup(FloatType* samples, size_t numSamples, State& state, size_t first) const noexcept
+{
+    static_assert(NumSections >= 1 && NumSections <= lanes, "A group has 1 to 'lanes' sections");
+
+    // Steps the last lane of the group is behind the first one
+    constexpr auto skew = (size_t) NumSections - 1;
+
+    // Too short to fill the pipeline: one section after the other
+    if (numSamples <= skew)
+    {
+        for (size_t k = 0; k < (size_t) NumSections; ++k)
+            for (size_t n = 0; n < numSamples; ++n)
+                samples[n] = processSection(cascade, state, first + k, samples[n]);
+
+        return;
+    }
+
+    // What each lane handed to the next one on the last step
+    alignas(16) std::array<FloatType, (size_t) lanes> handOff {};
+
+    // Filling: at step t only lanes 0 to t have a sample (t - k) to work on. Going down the lanes,
+    // each one reads what the lane below it handed over before it is replaced.
+    for (size_t t = 0; t < skew; ++t)
+    {
+        for (size_t k = t; k > 0; --k)
+            handOff[k] = processSection(cascade, state, first + k, handOff[k - 1]);
+
+        handOff[0] = processSection(cascade, state, first, samples[t]);
+    }
+
+    // Every lane busy: lane k filters sample t - k, the last lane's output is final. The operations
+    // are the ones of processSection, in the same order, on every lane at once.
+    {
+        const auto b0 = Register::load(cascade.b0.data() + first);
+        const auto b1 = Register::load(cascade.b1.data() + first);
+        const auto b2 = Register::load(cascade.b2.data() + first);
+        const auto a1 = Register::load(cascade.a1.data() + first);
+        const auto a2 = Register::load(cascade.a2.data() + first);
+
+        auto lv1 = Register::load(state.lv1.data() + first);
+        auto lv2 = Register::load(state.lv2.data() + first);
+        auto output = Register::load(handOff.data());
+
+        for (size_t t = skew; t < numSamples; ++t)
+        {
+            const auto input = Register::shiftIn(output, samples[t]);
+
+            output = Register::add(Register::mul(input, b0), lv1);
+            lv1 = Register::add(Register::sub(Register::mul(input, b1), Register::mul(output, a1)), lv2);
+            lv2 = Register::sub(Register::mul(input, b2), Register::mul(output, a2));
+
+            // Written behind the read position: the block can be filtered in place
+            samples[t - skew] = Register::template get<(int) skew>(output);
+        }
+
+        Register::store(state.lv1.data() + first, lv1);
+        Register::store(state.lv2.data() + first, lv2);
+        Register::store(handOff.data(), output);
+    }
+
+    // Draining: at step t only the lanes from t - numSamples + 1 up still have a sample to finish
+    for (size_t t = numSamples; t < numSamples + skew; ++t)
+    {
+        for (size_t k = skew; k > t - numSamples; --k)
+            handOff[k] = processSection(cascade, state, first + k, handOff[k - 1]);
+
+        samples[t - skew] = handOff[skew];
+    }
+}
+
+template<typename FloatType>
+void PipelinedChain<FloatType>::process(const juce::dsp::AudioBlock<FloatType>& block) noexcept
+{
+    const auto numChannels = juce::jmin(block.getNumChannels(), states.size());
+    const auto numSamples = block.getNumSamples();
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* samples = block.getChannelPointer(channel);
+        auto& state = states[channel];
+
+        // One group after the other over the whole block, the last one can be partly filled
+        for (int first = 0; first < cascade.numActive; first += lanes)
+        {
+            withGroupSize(juce::jmin(lanes, cascade.numActive - first), [&](auto numSections)
+            {
+                processGroup<decltype(numSections)::value>(samples, numSamples, state, (size_t) first);
+            });
+        }
+    }
+}
+
+// Single and double precision processing
+template class PipelinedChain<float>;
+template class PipelinedChain<double>;
@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+    PipelinedChain.h
+    Low cut --> Parametric bands --> High cut cascade of one channel at a time, consecutive sections in different SIMD lanes.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+//==============================================================================
+// The few operations the pipeline needs on a 128 bit register: 4 floats or 2 doubles, SSE or NEON.
+// Without either, a "register" is a single sample and the pipeline is the plain sequential cascade.
+template<typename FloatType>
+struct PipelineRegister
+{
+    using Native = FloatType;
+    static constexpr int lanes = 1;
+
+    static Native load(const FloatType* source) noexcept         { return *source; }
+    static void store(FloatType* destination, Native v) noexcept { *destination = v; }
+
+    static Native add(Native a, Native b) noexcept { return a + b; }
+    static Native sub(Native a, Native b) noexcept { return a - b; }
+    static Native mul(Native a, Native b) noexcept { return a * b; }
+
+    static Native shiftIn(Native, FloatType input) noexcept { return input; }
+
+    template<int Lane>
+    static FloatType get(Native v) noexcept { return v; }
+};
+
+#if JUCE_USE_SSE_INTRINSICS
+template<>
+struct PipelineRegister<float>
+{
+    using Native = __m128;
+    static constexpr int lanes = 4;
+
+    static Native load(const float* source) noexcept         { return _mm_load_ps(source); }
+    static void store(float* destination, Native v) noexcept { _mm_store_ps(destination, v); }
+
+    static Native add(Native a, Native b) noexcept { return _mm_add_ps(a, b); }
+    static Native sub(Native a, Native b) noexcept { return _mm_sub_ps(a, b); }
+    static Native mul(Native a, Native b) noexcept { return _mm_mul_ps(a, b); }
+
+    // { input, v0, v1, v2 }: every lane gets what the lane below it had
+    static Native shiftIn(Native v, float input) noexcept
+    {
+        return _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)), _mm_set_ss(input));
+    }
+
+    template<int Lane>
+    static float get(Native v) noexcept { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane))); }
+};
+
+template<>
+struct PipelineRegister<double>
+{
+    using Native = __m128d;
+    static constexpr int lanes = 2;
+
+    static Native load(const double* source) noexcept         { return _mm_load_pd(source); }
+    static void store(double* destination, Native v) noexcept { _mm_store_pd(destination, v); }
+
+    static Native add(Native a, Native b) noexcept { return _mm_add_pd(a, b); }
+    static Native sub(Native a, Native b) noexcept { return _mm_sub_pd(a, b); }
+    static Native mul(Native a, Native b) noexcept { return _mm_mul_pd(a, b); }
+
+    // { input, v0 }
+    static Native shiftIn(Native v, double input) noexcept { return _mm_unpacklo_pd(_mm_set_sd(input), v); }
+
+    template<int Lane>
+    static double get(Native v) noexcept { return _mm_cvtsd_f64(_mm_shuffle_pd(v, v, Lane)); }
+};
+#elif JUCE_USE_ARM_NEON
+template<>
+struct PipelineRegister<float>
+{
+    using Native = float32x4_t;
+    static constexpr int lanes = 4;
+
+    static Native load(const float* source) noexcept         { return vld1q_f32(source); }
+    static void store(float* destination, Native v) noexcept { vst1q_f32(destination, v); }
+
+    static Native add(Native a, Native b) noexcept { return vaddq_f32(a, b); }
+    static Native sub(Native a, Native b) noexcept { return vsubq_f32(a, b); }
+    static Native mul(Native a, Native b) noexcept { return vmulq_f32(a, b); }
+
+    // { input, v0, v1, v2 }: every lane gets what the lane below it had
+    static Native shiftIn(Native v, float input) noexcept { return vextq_f32(vdupq_n_f32(input), v, 3); }
+
+    template<int Lane>
+    static float get(Native v) noexcept { return vgetq_lane_f32(v, Lane); }
+};
+
+ #if JUCE_64BIT
+// 32 bit ARM has no double precision NEON: doubles stay on the sequential cascade there
+template<>
+struct PipelineRegister<double>
+{
+    using Native = float64x2_t;
+    static constexpr int lanes = 2;
+
+    static Native load(const double* source) noexcept         { return vld1q_f64(source); }
+    static void store(double* destination, Native v) noexcept { vst1q_f64(destination, v); }
+
+    static Native add(Native a, Native b) noexcept { return vaddq_f64(a, b); }
+    static Native sub(Native a, Native b) noexcept { return vsubq_f64(a, b); }
+    static Native mul(Native a, Native b) noexcept { return vmulq_f64(a, b); }
+
+    // { input, v0 }
+    static Native shiftIn(Native v, double input) noexcept { return vextq_f64(vdupq_n_f64(input), v, 1); }
+
+    template<int Lane>
+    static double get(Native v) noexcept { return vgetq_lane_f64(v, Lane); }
+};
+ #endif
+#endif
+
+//==============================================================================
+/**
+    Same filters as a MonoChain, each channel on its own, for mono and dual mono sessions
+    where there are not enough channels to fill the lanes of a SIMDChain.
+
+    A biquad depends on its own output of the previous sample, so a cascade running one
+    section after the other waits on that latency at every section. Here the running sections
+    are packed in groups of 'lanes' (4 floats or 2 doubles per register), section k of a group
+    in lane k. At every step lane k filters the sample lane k - 1 filtered on the step before:
+    the lanes work on samples skewed by one, and the whole group moves forward by one step for
+    the latency of a single section. The pipeline fills at the start of every block and drains
+    at its end (scalar, a few samples), so nothing is carried across blocks and there is no
+    added latency.
+
+    Each section still sees its samples in order and runs the transposed direct form II of
+    juce::dsp::IIR::Filter, one operation at a time, so the output matches the sequential
+    cascade of a SIMDChain within float rounding. Where the compiler is free to fuse multiplies
+    and adds into FMAs (clang on arm64 does by default), it does so differently in the scalar
+    and the vector code, and the last bits differ; low frequency sections amplify that.
+    SimplyQueueBenchmark checks the paths agree before timing them.
+*/
+template<typename FloatType>
+class PipelinedChain
+{
+public:
+    using Register = PipelineRegister<FloatType>;
+
+    // Sections advanced by one step of the pipeline
+    static constexpr int lanes = Register::lanes;
+
+    static_assert(maxNumChainSections % lanes == 0, "The groups tile the section arrays");
+
+    PipelinedChain() = default;
+
+    // Allocates one state per channel, for spec.numChannels channels
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    // Clears the state of every section
+    void reset() noexcept;
+
+    // Packs the running sections of a designed snapshot (no allocation). A section keeps its state
+    // when the ones around it come and go, a section coming back into use starts from a clean state.
+    void setCoefficients(const ChainCoefficients& chainCoefficients) noexcept;
+
+    // Filters the channels of the block in place (at most the number it was prepared with)
+    void process(const juce::dsp::AudioBlock<FloatType>& block) noexcept;
+
+    // Biquads running, all parts of the chain together
+    int getNumActiveSections() const noexcept { return cascade.numActive; }
+
+private:
+    // Structure of arrays: slot i holds the i-th running section, in chain order (low cut, bands,
+    // high cut). The slots of a group are contiguous and aligned, so they load as one register.
+    // The slots past numActive are all zero: their lanes output silence.
+    struct Cascade
+    {
+        alignas(16) std::array<FloatType, maxNumChainSections> b0 {}, b1 {}, b2 {}, a1 {}, a2 {};
+
+        std::array<int, maxNumChainSections> section {}; // Section running in each slot, see getSectionIndex
+        int numActive {0};
+    };
+
+    // Transposed direct form II state of one channel, indexed by slot
+    struct State
+    {
+        alignas(16) std::array<FloatType, maxNumChainSections> lv1 {}, lv2 {};
+    };
+
+    // Position of a section in the full chain: low cut 0 to 3, bands 4 to 11, high cut 12 to 15
+    static int getSectionIndex(ChainPositions position, int i) noexcept;
+
+    // One section, one sample: used to fill and drain the pipeline
+    static inline FloatType processSection(const Cascade& c, State& state, size_t slot, FloatType input) noexcept
+    {
+        const auto output = input * c.b0[slot] + state.lv1[slot];
+        state.lv1[slot] = (input * c.b1[slot]) - (output * c.a1[slot]) + state.lv2[slot];
+        state.lv2[slot] = (input * c.b2[slot]) - (output * c.a2[slot]);
+        return output;
+    }
+
+    // Runs the NumSections sections from slot 'first' over the samples in place
+    template<int NumSections>
+    void processGroup(FloatType* samples, size_t numSamples, State& state, size_t first) const noexcept;
+
+    // Calls function(std::integral_constant<int, N>) with N = numSections (1 to lanes)
+    template<int NumSections = 1, typename Function>
+    static void withGroupSize(int numSections, Function&& function)
+    {
+        if constexpr (NumSections < lanes)
+        {
+            if (numSections > NumSections)
+            {
+                withGroupSize<NumSections + 1>(numSections, function);
+                return;
+            }
+        }
+
+        function(std::integral_constant<int, NumSections>{});
+    }
+
+    Cascade cascade;
+    std::vector<State> states;
+
+    JUCE_LEAK_DETECTOR (PipelinedChain)
+};
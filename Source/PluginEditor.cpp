@@ -8,96 +8,150 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Tracer.h"
+#include "FrequencyResponse.h"
+#include "CoefficientDesigner.h"
 
 //======================= ResponseCurveComponent ==============================================================
 
 ResponseCurveComponent::ResponseCurveComponent(SimplyQueueAudioProcessor& p) : audioProcessor(p)
+#if SIMPLYQUEUE_SPECTRUM_ANALYZER
+, spectrumAnalyzer(p.getSpectrumAnalyzer())
+#endif
 {
-    // Now we can update any peak filter link with the chain settings, we need to listen when the parameters are being changed
-    // We grab all the parameters from the audio processor and add a listener to them.
-    const auto& parameters = audioProcessor.getParameters(); // returns an array of pointers
-    for (auto parameter : parameters)
-    {
-        parameter->addListener(this);
-    }
+    // paint() fills the whole component before drawing the spectra and the curve
+    setOpaque(true);
     
-    startTimerHz(60);
+    // Nothing runs until the component is on screen (see updateShowing)
 }
 
 ResponseCurveComponent::~ResponseCurveComponent()
 {
-    // De-register listeners
-    const auto& parameters = audioProcessor.getParameters(); // returns an array of pointers
-    for (auto parameter : parameters)
+    // Nothing may trigger us any more once we are gone
+    audioProcessor.setDesignNotifier(nullptr);
+    
+   #if SIMPLYQUEUE_SPECTRUM_ANALYZER
+    // Back to a single atomic check per block on the audio thread
+    spectrumAnalyzer.setActive(false);
+   #endif
+    
+    stopTimer();
+    cancelPendingUpdate();
+}
+
+void ResponseCurveComponent::paint(juce::Graphics &g)
+{
+    const Tracer::ScopedEvent traceEvent("ResponseCurveComponent::paint", getWidth());
+    
+    // Drawn at the resolution of the screen (2 on retina / 4K displays)
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    
+    if (scale != imageScale)
     {
-        parameter->removeListener(this);
+        imageScale = scale;
+        imageNeedsUpdate = true;
     }
+    
+    // Only redone when the filters, the size or the active bands changed. Otherwise painting
+    // is a copy of the cached image, whatever the slopes.
+    if (magnitudesNeedUpdate)
+        updateMagnitudes();
+    
+    if (imageNeedsUpdate)
+        updateImage();
+    
+    // (Our component is opaque, so we must completely fill the background with a solid colour)
+    g.fillAll (juce::Colours::black);
+    
+   #if SIMPLYQUEUE_SPECTRUM_ANALYZER
+    g.setColour(juce::Colours::slategrey.withAlpha(0.5f));
+    g.fillPath(inputSpectrum);
+    
+    g.setColour(juce::Colours::skyblue.withAlpha(0.7f));
+    g.strokePath(outputSpectrum, juce::PathStrokeType(1.0f));
+   #endif
+    
+    g.drawImage(curveImage, getLocalBounds().toFloat());
 }
 
-void ResponseCurveComponent::paint(juce::Graphics &g)
+void ResponseCurveComponent::resized()
 {
     using namespace juce;
     
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-    g.fillAll (Colours::black);
+    // One frequency per pixel, mapped to the human hearing range on a log scale
+    const auto width = getWidth();
     
-    // Area where we draw response curve
-    auto responseArea = getLocalBounds();
-    auto width = responseArea.getWidth();
+    frequencies.resize((size_t) juce::jmax(0, width));
+    magnitudes.resize(frequencies.size());
     
-    // Obtaining element in the chain
-    auto& lowcut = monoChain.get<ChainPositions::LowCut>();
-    auto& highcut = monoChain.get<ChainPositions::HighCut>();
-    auto& peak = monoChain.get<ChainPositions::Peak>();
+    for (int i = 0; i < width; ++i)
+        frequencies[(size_t) i] = mapToLog10(double(i) / double(width), 20.0, 20000.0);
     
-    // Needed for the getMagToFreq function
-    auto sampleRate = audioProcessor.getSampleRate();
+    responseCurve.preallocateSpace(3 * width + 3);
     
-    // Vector to store magnitudes
-    std::vector<double> magnitudes;
+   #if SIMPLYQUEUE_SPECTRUM_ANALYZER
+    spectrumAnalyzer.setDisplaySize(width, getHeight());
+   #endif
     
-    // Pre-allocation one magnitude per pixel
-    magnitudes.resize(width);
+    magnitudesNeedUpdate = true;
+    imageNeedsUpdate = true;
+}
+
+void ResponseCurveComponent::updateMagnitudes()
+{
+    using namespace juce;
     
-    // Iterate through each pixel and comput magnitude at that frequency
-    for(int i = 0; i < width; ++i)
+    const auto& snapshot = audioProcessor.getCoefficientSnapshot();
+    
+    // Nothing designed yet (not prepared): flat
+    if (snapshot.sampleRate <= 0.0)
     {
-        // Magnitudes are expressed in gain units (multiplicative)
-        double magnitude = 1.0;
-        
-        // Mapping normalised number to its frequency within the human hearing range
-        auto frequency = mapToLog10(double(i) / double(width), 20.0, 20000.0);
-        
-        // If peak is bypassed, no need to do the computation
-        if (!monoChain.isBypassed<ChainPositions::Peak>())
-            magnitude *= peak.coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        
-        // If low cut is bypassed, no need to do the computation
-        if (!lowcut.isBypassed<0>())
-            magnitude *= lowcut.get<0>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        if (!lowcut.isBypassed<1>())
-            magnitude *= lowcut.get<1>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        if (!lowcut.isBypassed<2>())
-            magnitude *= lowcut.get<2>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        if (!lowcut.isBypassed<3>())
-            magnitude *= lowcut.get<3>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        
-        // If high cut is bypassed, no need to do the computation
-        if (!highcut.isBypassed<0>())
-            magnitude *= highcut.get<0>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        if (!highcut.isBypassed<1>())
-            magnitude *= highcut.get<1>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        if (!highcut.isBypassed<2>())
-            magnitude *= highcut.get<2>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        if (!highcut.isBypassed<3>())
-            magnitude *= highcut.get<3>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+        std::fill(magnitudes.begin(), magnitudes.end(), 1.0);
+    }
+    else
+    {
+        // Every pixel in one call, skipping the bands the audio thread skips (see FrequencyResponse.h)
+        FrequencyResponseOutput output;
+        output.magnitudes = magnitudes.data();
         
-        // Convert magnitude into decibels and store it
-        magnitudes[i] = Decibels::gainToDecibels(magnitude);
+        computeFrequencyResponse(snapshot.coefficients, frequencies.data(), (int) frequencies.size(),
+                                 snapshot.sampleRate, output);
     }
     
-    // Convert vector of magnitude into a path to draw it
-    Path responseCurve;
+    // Magnitudes are expressed in gain units (multiplicative), convert them into decibels
+    for (auto& magnitude : magnitudes)
+        magnitude = Decibels::gainToDecibels(magnitude);
+    
+    magnitudesNeedUpdate = false;
+    imageNeedsUpdate = true;
+}
+
+void ResponseCurveComponent::updateImage()
+{
+    using namespace juce;
+    
+    imageNeedsUpdate = false;
+    
+    // Area where we draw response curve
+    auto responseArea = getLocalBounds();
+    
+    const auto imageWidth = roundToInt(responseArea.getWidth() * imageScale);
+    const auto imageHeight = roundToInt(responseArea.getHeight() * imageScale);
+    
+    if (imageWidth <= 0 || imageHeight <= 0)
+        return;
+    
+    // Only reallocated when the size changes. Transparent, the spectra show through.
+    if (curveImage.getWidth() != imageWidth || curveImage.getHeight() != imageHeight)
+        curveImage = Image(Image::ARGB, imageWidth, imageHeight, true);
+    else
+        curveImage.clear(curveImage.getBounds());
+    
+    Graphics g(curveImage);
+    g.addTransform(AffineTransform::scale(imageScale));
+    
+    // Convert the magnitudes into a path to draw it, reusing the path's memory
+    responseCurve.clear();
     
     // Max and min position in the window
     const double outputMin = responseArea.getBottom();
@@ -124,34 +178,127 @@ void ResponseCurveComponent::paint(juce::Graphics &g)
     
     g.setColour(Colours::mintcream);
     g.strokePath(responseCurve, PathStrokeType(2.0f));
+    
+    // Band names along the top: bright when the band runs, dimmed when it is skipped as neutral
+    auto labelArea = responseArea.reduced(6, 4).removeFromTop(16);
+    auto labelWidth = labelArea.getWidth() / 3;
+    
+    auto drawBandLabel = [&](bool active, const String& name, Justification justification)
+    {
+        g.setColour(active ? Colours::mintcream : Colours::darkgrey);
+        g.drawText(active ? name : name + " (off)",
+                   labelArea.removeFromLeft(labelWidth), justification);
+    };
+    
+    // The parametric bands share the middle: the numbers of the ones running
+    String bandNames;
+    
+    for (int band = 0; band < maxNumBands; ++band)
+        if (bandActive[(size_t) band])
+            bandNames << " " << (band + 1);
+    
+    g.setFont(12.0f);
+    drawBandLabel(lowCutActive, "Low Cut", Justification::centredLeft);
+    drawBandLabel(bandNames.isNotEmpty(), "Bands" + bandNames, Justification::centred);
+    drawBandLabel(highCutActive, "High Cut", Justification::centredRight);
 }
 
-void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue)
+void ResponseCurveComponent::handleAsyncUpdate()
 {
-    // We set our atomic flag to true, triggering the GUI update
-    parametersChanged.set(true);
+    // Hidden: whatever changed is picked up when shown again
+    if (! showing)
+        return;
+    
+    const auto sinceLastUpdate = juce::Time::getMillisecondCounterHiRes() - lastUpdateTime;
+    
+    // Too soon after the last one: a single update at the end of the frame, for everything
+    // coming in until then
+    if (sinceLastUpdate < minUpdateIntervalMs)
+    {
+        if (! isTimerRunning())
+            startTimer(juce::jmax(1, juce::roundToInt(minUpdateIntervalMs - sinceLastUpdate)));
+        
+        return;
+    }
+    
+    update();
 }
-// better
+
 void ResponseCurveComponent::timerCallback()
 {
-    if(parametersChanged.compareAndSetBool(false, true))
+    stopTimer();
+    update();
+}
+
+void ResponseCurveComponent::updateShowing()
+{
+    const auto nowShowing = isShowing();
+    
+    if (nowShowing == showing)
+        return;
+    
+    showing = nowShowing;
+    
+    // The designer tells us when it publishes new coefficients. A burst of automation only
+    // posts one message: triggers are coalesced until handled.
+    audioProcessor.setDesignNotifier(showing ? this : nullptr);
+    
+   #if SIMPLYQUEUE_SPECTRUM_ANALYZER
+    // Only copied on the audio thread and analysed while on screen
+    spectrumAnalyzer.setActive(showing, this);
+   #endif
+    
+    if (showing)
     {
-        // Update mono chain, signal repaint
-        auto chainSettings = getChainSettings(audioProcessor.apvts);
-        auto peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
-        updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-        
-        auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-        auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
+        triggerAsyncUpdate();
+    }
+    else
+    {
+        stopTimer();
+        cancelPendingUpdate();
+    }
+}
+
+void ResponseCurveComponent::update()
+{
+    lastUpdateTime = juce::Time::getMillisecondCounterHiRes();
+    
+    // The coefficients the processor published: no design work here, and the curve is exactly
+    // what the audio thread runs. Only redrawn when there is a newer version (a new editor
+    // starts from 0, so it draws whatever is there).
+    audioProcessor.pullCoefficientSnapshot();
+    const auto& snapshot = audioProcessor.getCoefficientSnapshot();
+    
+    if (snapshot.version != drawnVersion)
+    {
+        drawnVersion = snapshot.version;
+        magnitudesNeedUpdate = true;
         
-        updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-        updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+        // The designer skips the neutral bands on its own: redraw the labels when that changes
+        if (updateActiveBands(snapshot.coefficients))
+            imageNeedsUpdate = true;
         
         repaint();
-        // Mono chain from apvts is private so we need to add 'free' functions
-        
-        parametersChanged.set(false);
     }
+    
+   #if SIMPLYQUEUE_SPECTRUM_ANALYZER
+    // New spectra from the analyser's worker
+    if (spectrumAnalyzer.pullPaths(inputSpectrum, outputSpectrum))
+        repaint();
+   #endif
+}
+
+bool ResponseCurveComponent::updateActiveBands(const ChainCoefficients& chainCoefficients)
+{
+    const auto changed = chainCoefficients.lowCutActive != lowCutActive
+                      || chainCoefficients.highCutActive != highCutActive
+                      || chainCoefficients.bandActive != bandActive;
+    
+    lowCutActive = chainCoefficients.lowCutActive;
+    highCutActive = chainCoefficients.highCutActive;
+    bandActive = chainCoefficients.bandActive;
+    
+    return changed;
 }
 
 //======================= ResponseCurveComponent ==============================================================
@@ -159,18 +306,91 @@ void ResponseCurveComponent::timerCallback()
 
 
 
+#if SIMPLYQUEUE_LOAD_METER
+//======================= LoadMeterComponent ==================================================================
+LoadMeterComponent::LoadMeterComponent(LoadMeter& meter) : loadMeter(meter)
+{
+    // Nothing is measured until the meter is on screen (see updateShowing)
+}
+
+LoadMeterComponent::~LoadMeterComponent()
+{
+    loadMeter.setReading(false);
+}
+
+void LoadMeterComponent::updateShowing()
+{
+    const auto showing = isShowing();
+    
+    if (showing == isTimerRunning())
+        return;
+    
+    // The audio thread only times its blocks while someone reads them
+    loadMeter.setReading(showing);
+    
+    if (showing)
+        startTimerHz(10);
+    else
+        stopTimer();
+}
+
+void LoadMeterComponent::timerCallback()
+{
+    LoadMeter::Measurement total;
+    auto windowPeak = 0.0;
+    auto numBlocks = 0;
+    
+    loadMeter.pull([&](const LoadMeter::Measurement& measurement)
+    {
+        total.coefficientUpdate += measurement.coefficientUpdate;
+        total.filterProcessing += measurement.filterProcessing;
+        total.budget += measurement.budget;
+        
+        currentLoad = measurement.getLoad() * 100.0;
+        windowPeak = juce::jmax(windowPeak, currentLoad);
+        ++numBlocks;
+    });
+    
+    // Host stopped: nothing new to show
+    if (numBlocks == 0 || total.budget <= 0.0)
+        return;
+    
+    averageLoad = total.getLoad() * 100.0;
+    coefficientLoad = total.coefficientUpdate / total.budget * 100.0;
+    peakLoad = juce::jmax(windowPeak, peakLoad * 0.95);
+    
+    auto newText = "DSP " + juce::String(currentLoad, 1) + "%  avg " + juce::String(averageLoad, 1)
+                 + "%  peak " + juce::String(peakLoad, 1) + "%  (coefficients " + juce::String(coefficientLoad, 1) + "%)";
+    
+    if (newText != text)
+    {
+        text = newText;
+        repaint();
+    }
+}
+
+void LoadMeterComponent::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::grey);
+    g.setFont(12.0f);
+    g.drawFittedText(text, getLocalBounds(), juce::Justification::centredRight, 1);
+}
+//======================= LoadMeterComponent ==================================================================
+#endif
+
+
+
 //======================= SimplyQueueAudioProcessorEditor ====================================================
 SimplyQueueAudioProcessorEditor::SimplyQueueAudioProcessorEditor (SimplyQueueAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p),
-// TODO: Use an enum/look up table instead of using raw names (allows to iterates through it)
+// Parameter IDs come from the table (Parameters.h)
 responseCurveComponent(audioProcessor),
-lowCutFreqSliderAttachment(audioProcessor.apvts, "Low-Cut Freq", lowCutFreqSlider),
-highCutFreqSliderAttachment(audioProcessor.apvts, "High-Cut Freq", highCutFreqSlider),
-peakFreqSliderAttachment(audioProcessor.apvts, "Peak Freq", peakFreqSlider),
-peakGainSliderAttachment(audioProcessor.apvts, "Peak Gain", peakGainSlider),
-peakQSliderAttachment(audioProcessor.apvts, "Peak Q", peakQSlider),
-lowCutSlopeSliderAttachment(audioProcessor.apvts, "Low-Cut Slope", lowCutSlopeSlider),
-highCutSlopeSliderAttachment(audioProcessor.apvts, "High-Cut Slope", highCutSlopeSlider)
+lowCutFreqSliderAttachment(audioProcessor.apvts, getParameterId(LowCutFreq), lowCutFreqSlider),
+highCutFreqSliderAttachment(audioProcessor.apvts, getParameterId(HighCutFreq), highCutFreqSlider),
+lowCutSlopeSliderAttachment(audioProcessor.apvts, getParameterId(LowCutSlope), lowCutSlopeSlider),
+highCutSlopeSliderAttachment(audioProcessor.apvts, getParameterId(HighCutSlope), highCutSlopeSlider),
+linearPhaseButtonAttachment(audioProcessor.apvts, getParameterId(LinearPhase), linearPhaseButton),
+firLengthComboBoxAttachment(audioProcessor.apvts, getParameterId(FirLength), firLengthComboBox)
 
 {
     // Make sure that before the constructor has finished, you've set the
@@ -181,6 +401,30 @@ highCutSlopeSliderAttachment(audioProcessor.apvts, "High-Cut Slope", highCutSlop
         addAndMakeVisible(sliders);
     }
     
+    // Items first: an attachment selects the item matching its parameter
+    for (int band = 0; band < maxNumBands; ++band)
+        bandSelector.addItem("Band " + juce::String(band + 1), band + 1);
+    
+    bandTypeComboBox.addItemList(getChoiceNames(ChoiceList::BandTypes), 1);
+    
+    // The gain does nothing to a notch
+    bandTypeComboBox.onChange = [this]
+    {
+        bandGainSlider.setEnabled(bandTypeComboBox.getSelectedItemIndex() != Band_Notch);
+    };
+    
+    bandSelector.onChange = [this] { selectBand(bandSelector.getSelectedItemIndex()); };
+    bandSelector.setSelectedItemIndex(0, juce::dontSendNotification);
+    selectBand(0);
+    
+   #if SIMPLYQUEUE_TRACING
+    traceButton.onClick = [this] { traceButtonClicked(); };
+    
+    // Another editor may have started the trace already (there is one for the whole process)
+    if (Tracer::getInstance().isEnabled())
+        traceButton.setButtonText("Save trace...");
+   #endif
+    
     setSize (600, 400);
 }
 
@@ -210,6 +454,20 @@ void SimplyQueueAudioProcessorEditor::resized()
     
     responseCurveComponent.setBounds(responseArea);
     
+    // Bottom strip: linear phase mode on the left, FIR length next to it
+    auto optionsArea = bounds.removeFromBottom(30).reduced(4);
+    linearPhaseButton.setBounds(optionsArea.removeFromLeft(120));
+    firLengthComboBox.setBounds(optionsArea.removeFromLeft(100));
+    
+   #if SIMPLYQUEUE_TRACING
+    traceButton.setBounds(optionsArea.removeFromRight(100));
+   #endif
+    
+   #if SIMPLYQUEUE_LOAD_METER
+    // DSP load in the rest of the strip
+    loadMeterComponent.setBounds(optionsArea);
+   #endif
+    
     // 1/3 of the display on left
     auto lowCutArea = bounds.removeFromLeft(bounds.getWidth() * 0.33);
     // 1/3 of display right (width = 2/3, so * 0.5 = 1/3)
@@ -221,12 +479,39 @@ void SimplyQueueAudioProcessorEditor::resized()
     highCutFreqSlider.setBounds(highCutArea.removeFromTop(highCutArea.getHeight() * 0.5));
     highCutSlopeSlider.setBounds(highCutArea);
     
-    peakFreqSlider.setBounds(bounds.removeFromTop(bounds.getHeight() * 0.33));
-    peakGainSlider.setBounds(bounds.removeFromTop(bounds.getHeight() * 0.5));
-    peakQSlider.setBounds(bounds);
+    // Band picked, its type and its switch above its sliders
+    auto bandHeader = bounds.removeFromTop(24).reduced(2, 0);
+    auto bandHeaderWidth = bandHeader.getWidth() / 3;
+    
+    bandSelector.setBounds(bandHeader.removeFromLeft(bandHeaderWidth));
+    bandTypeComboBox.setBounds(bandHeader.removeFromLeft(bandHeaderWidth));
+    bandOnButton.setBounds(bandHeader);
+    
+    bandFreqSlider.setBounds(bounds.removeFromTop(bounds.getHeight() * 0.33));
+    bandGainSlider.setBounds(bounds.removeFromTop(bounds.getHeight() * 0.5));
+    bandQSlider.setBounds(bounds);
     
 }
 
+void SimplyQueueAudioProcessorEditor::selectBand(int band)
+{
+    const auto& indices = bandParameterTable[(size_t) juce::jlimit(0, maxNumBands - 1, band)];
+    auto& apvts = audioProcessor.apvts;
+    
+    // The old attachments go first, so the controls are never attached to two parameters
+    bandFreqSliderAttachment.reset();
+    bandGainSliderAttachment.reset();
+    bandQSliderAttachment.reset();
+    bandTypeComboBoxAttachment.reset();
+    bandOnButtonAttachment.reset();
+    
+    bandFreqSliderAttachment = std::make_unique<Attachment>(apvts, getParameterId(indices.freq), bandFreqSlider);
+    bandGainSliderAttachment = std::make_unique<Attachment>(apvts, getParameterId(indices.gain), bandGainSlider);
+    bandQSliderAttachment = std::make_unique<Attachment>(apvts, getParameterId(indices.quality), bandQSlider);
+    bandTypeComboBoxAttachment = std::make_unique<APVTS::ComboBoxAttachment>(apvts, getParameterId(indices.type), bandTypeComboBox);
+    bandOnButtonAttachment = std::make_unique<APVTS::ButtonAttachment>(apvts, getParameterId(indices.enabled), bandOnButton);
+}
+
 
 std::vector<juce::Component*> SimplyQueueAudioProcessorEditor::getSliders()
 {
@@ -234,11 +519,55 @@ std::vector<juce::Component*> SimplyQueueAudioProcessorEditor::getSliders()
     {
         &lowCutFreqSlider,
         &highCutFreqSlider,
-        &peakFreqSlider,
-        &peakGainSlider,
-        &peakQSlider,
+        &bandFreqSlider,
+        &bandGainSlider,
+        &bandQSlider,
+        &bandSelector,
+        &bandTypeComboBox,
+        &bandOnButton,
         &lowCutSlopeSlider,
         &highCutSlopeSlider,
+        &linearPhaseButton,
+        &firLengthComboBox,
+       #if SIMPLYQUEUE_LOAD_METER
+        &loadMeterComponent,
+       #endif
+       #if SIMPLYQUEUE_TRACING
+        &traceButton,
+       #endif
         &responseCurveComponent
     };
 }
+
+#if SIMPLYQUEUE_TRACING
+void SimplyQueueAudioProcessorEditor::traceButtonClicked()
+{
+    auto& tracer = Tracer::getInstance();
+    
+    if (! tracer.isEnabled())
+    {
+        tracer.setEnabled(true);
+        traceButton.setButtonText("Save trace...");
+        return;
+    }
+    
+    // Stop first, so the buffers are quiet while they are written out
+    tracer.setEnabled(false);
+    traceButton.setButtonText("Start trace");
+    
+    traceFileChooser = std::make_unique<juce::FileChooser>("Save the trace (Chrome / Perfetto JSON)",
+                                                           juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                                                               .getChildFile("SimplyQueue trace.json"),
+                                                           "*.json");
+    
+    traceFileChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+                                      | juce::FileBrowserComponent::warnAboutOverwriting,
+                                  [](const juce::FileChooser& chooser)
+    {
+        const auto file = chooser.getResult();
+        
+        if (file != juce::File())
+            Tracer::getInstance().writeChromeJson(file);
+    });
+}
+#endif
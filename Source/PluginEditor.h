@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "Tracer.h"
 
 struct CustomRotarySlider : juce::Slider
 {
@@ -17,29 +18,25 @@ struct CustomRotarySlider : juce::Slider
                                         juce::Slider::TextEntryBoxPosition::NoTextBox){}
 };
 
+// Combo box listing the FIR lengths of the linear phase mode, filled before its attachment is created
+struct FirLengthComboBox : juce::ComboBox
+{
+    FirLengthComboBox() { addItemList(LinearPhaseFilter::getFirLengthNames(), 1); }
+};
+
+// Draws the coefficients the processor publishes, it designs nothing itself. Redrawn when something
+// changed, never polled: the designer (new coefficients) and the spectrum analyser trigger an async
+// update, coalesced and limited to one update per frame.
 struct ResponseCurveComponent: juce::Component,
-juce::AudioProcessorParameter::Listener,
+juce::AsyncUpdater,
 juce::Timer
 {
     ResponseCurveComponent(SimplyQueueAudioProcessor&);
     ~ResponseCurveComponent();
     
-    void parameterValueChanged (int parameterIndex, float newValue) override;
-    /** Indicates that a parameter change gesture has started.
-
-        E.g. if the user is dragging a slider, this would be called with gestureIsStarting
-        being true when they first press the mouse button, and it will be called again with
-        gestureIsStarting being false when they release it.
-
-        IMPORTANT NOTE: This will be called synchronously, and many audio processors will
-        call it during their audio callback. This means that not only has your handler code
-        got to be completely thread-safe, but it's also got to be VERY fast, and avoid
-        blocking. If you need to handle this event on your message thread, use this callback
-        to trigger an AsyncUpdater or ChangeBroadcaster which you can respond to later on the
-        message thread.
-    */
-    void parameterGestureChanged (int parameterIndex, bool gestureIsStarting) override {}
-
+    void handleAsyncUpdate() override;
+    
+    // Only runs to do an update deferred by the rate limit, then stops
     void timerCallback() override;
     /** Starts the timer and sets the length of interval required.
 
@@ -52,16 +49,87 @@ juce::Timer
     */
     
     void paint(juce::Graphics& g) override;
+    void resized() override;
+    
+    // Closed or hidden: nothing is notified, the analyser is stopped
+    void visibilityChanged() override { updateShowing(); }
+    void parentHierarchyChanged() override { updateShowing(); }
 
 private:
     SimplyQueueAudioProcessor& audioProcessor;
     
-    juce::Atomic<bool> parametersChanged {false};
+    // Version of the coefficient snapshot the curve shows, 0 for none
+    juce::uint32 drawnVersion {0};
     
-    // Using an instance of monochain used in audio processor, to update reponse curve
-    MonoChain monoChain;
+    // At most one update per frame: changes coming in faster are gathered into the next one
+    static constexpr double minUpdateIntervalMs = 1000.0 / 60.0;
+    double lastUpdateTime {0.0};
+    
+    bool showing {false};
+    
+    // Everything that may have changed since the last update
+    void update();
+    
+    // Follows isShowing(): notifications and analyser only while the curve is on screen
+    void updateShowing();
+    
+    // The curve is only computed again when the filters or the size change, and only drawn
+    // again when the curve, the labels or the display scale change. paint() draws the spectra
+    // and copies the image (transparent around the curve) over them.
+    std::vector<double> frequencies; // One per pixel, set in resized()
+    std::vector<double> magnitudes;  // Decibels at those frequencies
+    juce::Path responseCurve;
+    juce::Image curveImage;
+    float imageScale {1.0f};
+    
+    bool magnitudesNeedUpdate {true};
+    bool imageNeedsUpdate {true};
+    
+    void updateMagnitudes();
+    void updateImage();
+    
+    // Bands the processor currently runs: switched off and neutral ones are skipped
+    bool lowCutActive {true}, highCutActive {true};
+    BandMask bandActive {};
+    
+    // Reads the active bands of a snapshot, returns true if any changed
+    bool updateActiveBands(const ChainCoefficients& chainCoefficients);
+    
+   #if SIMPLYQUEUE_SPECTRUM_ANALYZER
+    // Spectra of the input (filled) and the output (line) behind the curve, built by the
+    // analyser's worker thread: here they are only drawn
+    SpectrumAnalyzer& spectrumAnalyzer;
+    juce::Path inputSpectrum, outputSpectrum;
+   #endif
+
+};
 
+#if SIMPLYQUEUE_LOAD_METER
+// Text line with the DSP load of the processor, in % of the real time each block has
+struct LoadMeterComponent : juce::Component, juce::Timer
+{
+    LoadMeterComponent(LoadMeter&);
+    ~LoadMeterComponent();
+    
+    void timerCallback() override;
+    void paint(juce::Graphics& g) override;
+    
+    // Only measures and refreshes while it is on screen
+    void visibilityChanged() override { updateShowing(); }
+    void parentHierarchyChanged() override { updateShowing(); }
+    
+private:
+    LoadMeter& loadMeter;
+    
+    void updateShowing();
+    
+    // All in % of the budget. Current is the last block, average and coefficients cover the
+    // blocks since the last timer callback, peak is held and falls back slowly.
+    double currentLoad {0.0}, averageLoad {0.0}, peakLoad {0.0}, coefficientLoad {0.0};
+    
+    juce::String text;
 };
+#endif
 
 
 //==============================================================================
@@ -82,17 +150,38 @@ private:
     // access the processor object that created it.
     SimplyQueueAudioProcessor& audioProcessor;
         
-    // Adding sliders
+    // Adding sliders. The band sliders control the band picked in bandSelector.
     CustomRotarySlider lowCutFreqSlider,
     highCutFreqSlider,
-    peakFreqSlider,
-    peakGainSlider,
-    peakQSlider,
+    bandFreqSlider,
+    bandGainSlider,
+    bandQSlider,
     lowCutSlopeSlider,
     highCutSlopeSlider;
     
+    // Parametric band shown by the band controls, its type and its switch
+    juce::ComboBox bandSelector;
+    juce::ComboBox bandTypeComboBox;
+    juce::ToggleButton bandOnButton {"On"};
+    
+    // Linear phase mode and the length of its FIR
+    juce::ToggleButton linearPhaseButton {"Linear Phase"};
+    FirLengthComboBox firLengthComboBox;
+    
     ResponseCurveComponent responseCurveComponent;
     
+   #if SIMPLYQUEUE_LOAD_METER
+    LoadMeterComponent loadMeterComponent {audioProcessor.getLoadMeter()};
+   #endif
+    
+   #if SIMPLYQUEUE_TRACING
+    // First click starts recording, the second one stops it and saves the trace
+    juce::TextButton traceButton {"Start trace"};
+    std::unique_ptr<juce::FileChooser> traceFileChooser;
+    
+    void traceButtonClicked();
+   #endif
+    
     // apvts alias to connect GUI sliders to DSP
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
@@ -100,12 +189,23 @@ private:
     // Creating 1 attachment for each slider
     Attachment lowCutFreqSliderAttachment,
     highCutFreqSliderAttachment,
-    peakFreqSliderAttachment,
-    peakGainSliderAttachment,
-    peakQSliderAttachment,
     lowCutSlopeSliderAttachment,
     highCutSlopeSliderAttachment;
     
+    APVTS::ButtonAttachment linearPhaseButtonAttachment;
+    APVTS::ComboBoxAttachment firLengthComboBoxAttachment;
+    
+    // The band controls are attached to the parameters of the selected band, made again when it changes
+    std::unique_ptr<Attachment> bandFreqSliderAttachment,
+    bandGainSliderAttachment,
+    bandQSliderAttachment;
+    
+    std::unique_ptr<APVTS::ComboBoxAttachment> bandTypeComboBoxAttachment;
+    std::unique_ptr<APVTS::ButtonAttachment> bandOnButtonAttachment;
+    
+    // Attaches the band controls to the parameters of band (0 to maxNumBands - 1)
+    void selectBand(int band);
+    
     // Vectorise sliders for each of access
     std::vector<juce::Component*> getSliders();
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimplyQueueAudioProcessorEditor)
@@ -8,6 +8,9 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "CoefficientDesigner.h"
+#include "RealtimeGuard.h"
+#include "Tracer.h"
 
 //==============================================================================
 SimplyQueueAudioProcessor::SimplyQueueAudioProcessor()
@@ -22,10 +25,22 @@ SimplyQueueAudioProcessor::SimplyQueueAudioProcessor()
                        )
 #endif
 {
+    coefficientDesigner = std::make_unique<CoefficientDesigner>(apvts);
+    
+    // The linear phase FIR is built from the designs, on the same background thread
+    coefficientDesigner->setListener(&linearPhaseFilter);
+    
+    // The linear phase settings change the latency: they are followed on the message thread
+    apvts.addParameterListener(getParameterId(LinearPhase), this);
+    apvts.addParameterListener(getParameterId(FirLength), this);
 }
 
 SimplyQueueAudioProcessor::~SimplyQueueAudioProcessor()
 {
+    apvts.removeParameterListener(getParameterId(LinearPhase), this);
+    apvts.removeParameterListener(getParameterId(FirLength), this);
+    
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -63,7 +78,14 @@ bool SimplyQueueAudioProcessor::isMidiEffect() const
 
 double SimplyQueueAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    const auto sampleRate = getSampleRate();
+    
+    // Not prepared yet
+    if (sampleRate <= 0.0)
+        return 0.0;
+    
+    // The mode the latency is reported for, the audio thread follows it within a block
+    return getTailLengthInSamples(linearPhaseEnabled.load()) / sampleRate;
 }
 
 int SimplyQueueAudioProcessor::getNumPrograms()
@@ -106,17 +128,70 @@ void SimplyQueueAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
     
     spec.sampleRate = sampleRate; // Sample rate used
     
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    // Same settings on every channel of the bus, from mono up to maxNumChannels
+    const auto numChannels = juce::jlimit(1, (int) maxNumChannels, getTotalNumOutputChannels());
     
-    // Update each filters using helper function
-    updateFilters();
+    // The designer builds the linear phase FIRs on its thread: stop it before the convolutions are replaced
+    coefficientDesigner->release();
+    
+    auto linearPhaseSpec = spec;
+    linearPhaseSpec.numChannels = (juce::uint32) numChannels;
+    linearPhaseFilter.prepare(linearPhaseSpec);
+    
+    linearPhaseBuffer.setSize(isUsingDoublePrecision() ? numChannels : 0, samplesPerBlock);
+    
+    // The latency is reported here, before the host starts calling processBlock
+    updateLinearPhaseSettings();
+    linearPhaseActive = linearPhaseEnabled.load();
+    
+    // Filters in the precision the host is going to call us with, the other ones are dropped
+    if (isUsingDoublePrecision())
+    {
+        prepareChains(doubleChains, spec, numChannels);
+        floatChains.monoChains.clear();
+    }
+    else
+    {
+        prepareChains(floatChains, spec, numChannels);
+        doubleChains.monoChains.clear();
+    }
+    
+    // New sample rate: every band is redesigned right now, then followed in the background
+    coefficientDesigner->prepare(sampleRate);
+    
+    // Offline, the output must not depend on how long the FIR takes to load: the first block
+    // waits for it instead of being muted
+    if (isNonRealtime() && linearPhaseActive)
+    {
+        const auto loaded = linearPhaseFilter.waitUntilFirLoaded(firLoadTimeoutMs);
+        jassert(loaded);
+        juce::ignoreUnused(loaded);
+    }
+    
+    loadMeter.prepare(sampleRate);
+    spectrumAnalyzer.prepare(sampleRate);
+    
+    // The first design is applied straight away, no ramp from whatever was there before
+    activeSubBlockSize = 0;
+    updateSmoothingRamp();
+    
+    if (coefficientDesigner->pullLatest())
+    {
+        coefficientSmoother.reset(coefficientDesigner->getLatest());
+        updateChains(coefficientSmoother.getCurrentCoefficients());
+    }
+    
+    samplesUntilCoefficientUpdate = 0;
+    
+    silentSamples = 0;
+    isIdle = false;
 }
 
 void SimplyQueueAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    coefficientDesigner->release();
 }
 
 
@@ -128,11 +203,11 @@ bool SimplyQueueAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     return true;
   #else
     // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // The same EQ is applied to every channel, so any layout from mono up to
+    // maxNumChannels channels works (stereo, 5.1, 7.1.4, ...).
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+    
+    if (mainOutput.isDisabled() || mainOutput.size() > (int) maxNumChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -147,9 +222,61 @@ bool SimplyQueueAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 #endif
 
 
-void SimplyQueueAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+template<typename SampleType>
+void SimplyQueueAudioProcessor::prepareChains(ProcessingChains<SampleType>& chains, juce::dsp::ProcessSpec spec, int numChannels)
+{
+    // Fresh chains for the new layout. Allocate the coefficient storage here, processBlock only ever writes into it
+    chains.monoChains.clear();
+    chains.monoChains.resize((size_t) numChannels);
+    
+    for (auto& chain : chains.monoChains)
+    {
+        prepareCoefficientStorage(chain);
+        chain.prepare(spec);
+    }
+    
+    // The SIMD and pipelined paths carry every channel in one chain
+    spec.numChannels = (juce::uint32) numChannels;
+    chains.simdChain.prepare(spec);
+    chains.pipelinedChain.prepare(spec);
+}
+
+bool SimplyQueueAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+void SimplyQueueAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    // Nothing in here may allocate or lock (checked by the realtime check tool, compiled out otherwise)
+    SIMPLYQUEUE_REALTIME_SCOPE
+    
+    // Block length as the argument, host buffer sizes show up in the trace
+    const Tracer::ScopedEvent traceEvent("processBlock", buffer.getNumSamples());
+    
+    processBlockWith(buffer, floatChains);
+}
+
+void SimplyQueueAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    SIMPLYQUEUE_REALTIME_SCOPE
+    
+    const Tracer::ScopedEvent traceEvent("processBlock (double)", buffer.getNumSamples());
+    
+    processBlockWith(buffer, doubleChains);
+}
+
+template<typename SampleType>
+void SimplyQueueAudioProcessor::processBlockWith(juce::AudioBuffer<SampleType>& buffer, ProcessingChains<SampleType>& chains)
 {
     juce::ScopedNoDenormals noDenormals;
+    
+    // Only copies the input and the output while the editor shows their spectra
+    SpectrumAnalyzer::BlockTap<SampleType> spectrumTap(spectrumAnalyzer, buffer);
+    
+    // Only times anything while the editor shows the DSP load
+    LoadMeter::BlockTimer blockTimer(loadMeter, buffer.getNumSamples());
+    
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -166,26 +293,299 @@ void SimplyQueueAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     //                 Check 'PrepareToPlay' for same code with explaination
     // ------------------------------------------------------------------------------------
     
-    // Update each filters using helper function
+    // Pick up the coefficients designed in the background, if they changed (no design work, no allocation)
     updateFilters();
     
+    // When switching path, the one taking over starts from a clean state instead of the one
+    // it had when it was last used
+    const auto newProcessingPath = processingPath.load();
+    
+    if (newProcessingPath != activeProcessingPath)
+    {
+        if (newProcessingPath == ProcessingPath::simdLanes)
+        {
+            chains.simdChain.reset();
+        }
+        else if (newProcessingPath == ProcessingPath::pipelinedSections)
+        {
+            chains.pipelinedChain.reset();
+        }
+        else
+        {
+            for (auto& chain : chains.monoChains)
+                chain.reset();
+        }
+        
+        activeProcessingPath = newProcessingPath;
+    }
+    
+    // Same when switching between the IIR chains and the linear phase FIR
+    if (updateLinearPhase())
+    {
+        if (linearPhaseActive)
+            linearPhaseFilter.reset();
+        else
+            resetChains(chains);
+    }
+    
+    blockTimer.lapCoefficientUpdate();
+    
+    // ------------------------------------------------------------------------------------
+    // Silence detection: once the input has been silent for longer than the tail of the filters,
+    // the output is silent as well and there is nothing left to filter. The chains are cleared
+    // once, then left alone until signal comes back, which is processed straight away.
+    // ------------------------------------------------------------------------------------
+    if (isInputSilent(buffer))
+    {
+        const auto tailInSamples = (juce::int64) std::ceil(getTailLengthInSamples(linearPhaseActive));
+        
+        if (silentSamples >= tailInSamples)
+        {
+            if (! isIdle)
+            {
+                resetChains(chains);
+                linearPhaseFilter.reset();
+                isIdle = true;
+            }
+            
+            coefficientUpdatesInLastBlock = 0;
+            return;
+        }
+        
+        silentSamples += buffer.getNumSamples();
+    }
+    else
+    {
+        silentSamples = 0;
+        isIdle = false;
+    }
+    
+    // Linear phase: the whole block goes through the FIR, the IIR chains are not used
+    if (linearPhaseActive)
+    {
+        processLinearPhase(buffer);
+        blockTimer.lapFilterProcessing();
+        
+        coefficientUpdatesInLastBlock = 0;
+        return;
+    }
+    
     /* Processor chain needs a processing context to be passed to it in order to run the audio through the links in the chain.
     // We supply this context using an audio block instance */
     
     // Create an audio block from the current buffer
-    juce::dsp::AudioBlock<float> block(buffer);
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    
+    const auto numSamples = (int) block.getNumSamples();
+    auto coefficientUpdates = 0;
+    
+    // ------------------------------------------------------------------------------------
+    // While a ramp is running, the block is cut on the sub-block grid and the coefficients move
+    // one step at the start of every sub-block. Once the ramp is done, the rest of the block
+    // goes through in one go.
+    // ------------------------------------------------------------------------------------
+    for (int position = 0; position < numSamples;)
+    {
+        if (coefficientSmoother.isSmoothing() && samplesUntilCoefficientUpdate == 0)
+        {
+            updateChains(coefficientSmoother.getNextCoefficients());
+            
+            samplesUntilCoefficientUpdate = activeSubBlockSize;
+            ++coefficientUpdates;
+            
+            blockTimer.lapCoefficientUpdate();
+        }
+        
+        auto length = numSamples - position;
+        
+        if (samplesUntilCoefficientUpdate > 0)
+        {
+            length = juce::jmin(length, samplesUntilCoefficientUpdate);
+            samplesUntilCoefficientUpdate -= length;
+        }
+        
+        auto subBlock = block.getSubBlock((size_t) position, (size_t) length);
+        processChains(subBlock, chains);
+        blockTimer.lapFilterProcessing();
+        
+        position += length;
+    }
+    
+    coefficientUpdatesInLastBlock = coefficientUpdates;
+}
+
+int SimplyQueueAudioProcessor::getFirLength() const
+{
+    const auto index = juce::jlimit(0, (int) LinearPhaseFilter::firLengths.size() - 1,
+                                    parameterValues.getChoice(FirLength));
+    
+    return LinearPhaseFilter::firLengths[(size_t) index];
+}
+
+void SimplyQueueAudioProcessor::updateLinearPhaseSettings()
+{
+    const auto useLinearPhase = parameterValues.getBool(LinearPhase);
+    const auto firLength = getFirLength();
+    
+    linearPhaseFilter.setFirLength(firLength);
+    linearPhaseFilter.setEnabled(useLinearPhase);
+    
+    // The host compensates the delay of the FIR
+    const auto latency = useLinearPhase ? linearPhaseFilter.getLatencySamples(firLength) : 0;
+    
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+    
+    // Only once the latency is reported does the audio thread switch
+    linearPhaseEnabled = useLinearPhase;
+}
+
+void SimplyQueueAudioProcessor::parameterChanged(const juce::String&, float)
+{
+    // Hosts can send automation from the audio thread: only the message thread updates the settings
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        updateLinearPhaseSettings();
+    else
+        triggerAsyncUpdate();
+}
+
+void SimplyQueueAudioProcessor::handleAsyncUpdate()
+{
+    updateLinearPhaseSettings();
+}
+
+bool SimplyQueueAudioProcessor::updateLinearPhase()
+{
+    const auto useLinearPhase = linearPhaseEnabled.load();
+    
+    if (useLinearPhase == linearPhaseActive)
+        return false;
     
-    // Get the audio blocks for each channels
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
+    linearPhaseActive = useLinearPhase;
+    return true;
+}
 
-    // Wrap an audio block into a context which we can pass to filters
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+double SimplyQueueAudioProcessor::getTailLengthInSamples(bool linearPhase) const
+{
+    // The linear phase FIR lasts its whole length, after the latency of the convolution
+    if (linearPhase)
+    {
+        const auto firLength = linearPhaseFilter.getFirLength();
+        return linearPhaseFilter.getLatencySamples(firLength) + firLength / 2;
+    }
+    
+    // How long the current filters keep ringing once the input stops
+    return coefficientDesigner->getTailLengthSeconds() * getSampleRate();
+}
 
-    // Process current block using the filters
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+template<typename SampleType>
+void SimplyQueueAudioProcessor::processLinearPhase(juce::AudioBuffer<SampleType>& buffer)
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        linearPhaseFilter.process(juce::dsp::AudioBlock<float>(buffer));
+    }
+    else
+    {
+        // The convolution runs in float: go through a copy of the buffer
+        const auto numChannels = juce::jmin(buffer.getNumChannels(), linearPhaseBuffer.getNumChannels());
+        const auto numSamples = juce::jmin(buffer.getNumSamples(), linearPhaseBuffer.getNumSamples());
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* source = buffer.getReadPointer(channel);
+            auto* copy = linearPhaseBuffer.getWritePointer(channel);
+            
+            for (int i = 0; i < numSamples; ++i)
+                copy[i] = (float) source[i];
+        }
+        
+        juce::dsp::AudioBlock<float> block(linearPhaseBuffer);
+        linearPhaseFilter.process(block.getSubsetChannelBlock(0, (size_t) numChannels).getSubBlock(0, (size_t) numSamples));
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* copy = linearPhaseBuffer.getReadPointer(channel);
+            auto* destination = buffer.getWritePointer(channel);
+            
+            for (int i = 0; i < numSamples; ++i)
+                destination[i] = (SampleType) copy[i];
+        }
+    }
+}
+
+template<typename SampleType>
+bool SimplyQueueAudioProcessor::isInputSilent(const juce::AudioBuffer<SampleType>& buffer) const
+{
+    // Cleared buffers are flagged by JUCE, no need to look at the samples
+    if (buffer.hasBeenCleared())
+        return true;
+    
+    return buffer.getMagnitude(0, buffer.getNumSamples()) < (SampleType) silenceThreshold;
+}
+
+template<typename SampleType>
+void SimplyQueueAudioProcessor::resetChains(ProcessingChains<SampleType>& chains)
+{
+    for (auto& chain : chains.monoChains)
+        chain.reset();
+    
+    chains.simdChain.reset();
+    chains.pipelinedChain.reset();
+}
+
+void SimplyQueueAudioProcessor::updateChains(const ChainCoefficients& chainCoefficients)
+{
+    // Only the chains of the precision in use were prepared
+    if (isUsingDoublePrecision())
+        updateChains(doubleChains, chainCoefficients);
+    else
+        updateChains(floatChains, chainCoefficients);
+    
+    activeSections = getActiveSections(chainCoefficients);
+}
+
+template<typename SampleType>
+void SimplyQueueAudioProcessor::updateChains(ProcessingChains<SampleType>& chains, const ChainCoefficients& chainCoefficients)
+{
+    for (auto& chain : chains.monoChains)
+        updateChain(chain, chainCoefficients);
+    
+    chains.simdChain.setCoefficients(chainCoefficients);
+    chains.pipelinedChain.setCoefficients(chainCoefficients);
+}
+
+template<typename SampleType>
+void SimplyQueueAudioProcessor::processChains(juce::dsp::AudioBlock<SampleType>& block, ProcessingChains<SampleType>& chains)
+{
+    // All the channels go through the cascade together
+    if (activeProcessingPath == ProcessingPath::simdLanes)
+    {
+        chains.simdChain.process(block);
+        return;
+    }
+    
+    // Each channel on its own, several sections of the cascade at once
+    if (activeProcessingPath == ProcessingPath::pipelinedSections)
+    {
+        chains.pipelinedChain.process(block);
+        return;
+    }
+    
+    // Never more chains than the bus was prepared with, nor more than the buffer holds
+    const auto numChannels = juce::jmin(block.getNumChannels(), chains.monoChains.size());
+    
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        // Get the audio block for this channel
+        auto channelBlock = block.getSingleChannelBlock(channel);
+        
+        // Wrap an audio block into a context which we can pass to filters
+        juce::dsp::ProcessContextReplacing<SampleType> context(channelBlock);
+        
+        // Process current block using the filters, only the cut sections of the current slopes run
+        processChain(chains.monoChains[channel], context, activeSections);
+    }
 }
 
 //==============================================================================
@@ -219,142 +619,87 @@ void SimplyQueueAudioProcessor::setStateInformation (const void* data, int sizeI
     // whose contents will have been created by the getStateInformation() call.
     // Restore parameters from apvts using a helper function
     
+    const Tracer::ScopedEvent traceEvent("setStateInformation", sizeInBytes);
+    
     // Checking if state is valid before using it as plugin state
     auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
     if(tree.isValid())
     {
         apvts.replaceState(tree);
-        updateFilters();
+        
+        // Redesign everything in the background, the audio thread picks it up when ready
+        coefficientDesigner->triggerFullUpdate();
     }
 }
 
-// Getting the parameter's values using the ChainSettings structure
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
+// Function picking up the newest coefficients
+void SimplyQueueAudioProcessor::updateFilters()
 {
-    ChainSettings settings;
+    updateSmoothingRamp();
     
-    // Gets settings in the range we have defined the sliders. For normalised values, use apvts.getParameter()
-    settings.lowCutFreq = apvts.getRawParameterValue("Low-Cut Freq")->load();
-    settings.highCutFreq = apvts.getRawParameterValue("High-Cut Freq")->load();
-    settings.peakFreq = apvts.getRawParameterValue("Peak Freq")->load();
-    settings.peakGainInDecibels = apvts.getRawParameterValue("Peak Gain")->load();
-    settings.peakQuality = apvts.getRawParameterValue("Peak Q")->load();
-    settings.lowCutSlope = static_cast<SlopeSettings> (apvts.getRawParameterValue("Low-Cut Slope")->load());
-    settings.highCutSlope = static_cast<SlopeSettings> (apvts.getRawParameterValue("High-Cut Slope")->load());
-
-    return settings;
+    // Nothing new published since the last block: the chains are up to date
+    if (! coefficientDesigner->pullLatest())
+        return;
+    
+    // The new coefficients become the target of a ramp, starting on the next sub-block
+    coefficientSmoother.setTarget(coefficientDesigner->getLatest());
+    samplesUntilCoefficientUpdate = 0;
 }
 
-// Free function (non-member function)
-Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate)
+void SimplyQueueAudioProcessor::updateSmoothingRamp()
 {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
-                                                               chainSettings.peakFreq,
-                                                               chainSettings.peakQuality,
-                                                               juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+    const auto subBlockSize = smoothingSubBlockSize.load();
+    
+    if (subBlockSize == activeSubBlockSize)
+        return;
+    
+    activeSubBlockSize = subBlockSize;
+    samplesUntilCoefficientUpdate = juce::jmin(samplesUntilCoefficientUpdate, activeSubBlockSize);
+    
+    // Same ramp time whatever the grid: a smaller sub-block means more (smaller) steps
+    coefficientSmoother.setRampLength(juce::roundToInt(smoothingTimeSeconds * getSampleRate() / subBlockSize));
 }
 
+size_t SimplyQueueAudioProcessor::getCutFilterTableMemory() const
+{
+    return coefficientDesigner->getCutFilterTableMemory();
+}
 
-void SimplyQueueAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings)
+void SimplyQueueAudioProcessor::setNeutralBandThreshold(float decibels)
 {
-    auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
-    
-    // ------------------------------------------------------------------------------------
-    // Access peak filter link and assign some coefficients
-    // PeakCoefficient object is a Reference-counted wrapper of an array allocated on the heap.
-    // To copy its values, we need to dereference it as it's a pointer.
-    // Allocation on the heap in an audio callback is BAD
-    // ------------------------------------------------------------------------------------
+    coefficientDesigner->setNeutralBandThreshold(decibels);
+}
 
-    // Accessing each individual links in a the chain of filter.
-    // Index in chain represent each filter
-    updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+float SimplyQueueAudioProcessor::getNeutralBandThreshold() const
+{
+    return coefficientDesigner->getNeutralBandThreshold();
 }
 
-// Getting the coefficients from above (left/rightChain.get), so we dereference
-void updateCoefficients(Coefficients& old, const Coefficients& replacements)
+bool SimplyQueueAudioProcessor::pullCoefficientSnapshot()
 {
-    // Reference counted objects allocated on the heap, so we need to dereference them to get underlying object
-    *old = *replacements;
+    return coefficientDesigner->pullSnapshot();
 }
 
-void SimplyQueueAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings)
+const CoefficientSnapshot& SimplyQueueAudioProcessor::getCoefficientSnapshot() const
 {
-    // ------------------------------------------------------------------------------------
-    // Creates 1 IIR filter coefficient object for every 2 orders
-    // If 12db selected = order of 2 (1 coefficient), If 48db selected = order of 8 (4 coefficients = 4 filter of 12db activated)
-    // dB slope choice [0,1,2,3] --> +1 * 2 --> [2, 4, 6, 8]
-    // ------------------------------------------------------------------------------------
-    
-    auto lowCutCoefficients  = makeLowCutFilter(chainSettings, getSampleRate());
-    
-    // Init right low cut filter chain
-    auto& leftLowCut = leftChain.get<ChainPositions::LowCut>();
-    auto& rightLowCut = rightChain.get<ChainPositions::LowCut>();
-    
-    updateCutFilter(leftLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(rightLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
+    return coefficientDesigner->getSnapshot();
 }
 
-void SimplyQueueAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings)
+void SimplyQueueAudioProcessor::setDesignNotifier(juce::AsyncUpdater* notifier)
 {
-    // Low pass / high cut filter
-    auto highCutCoefficients  = makeHighCutFilter(chainSettings, getSampleRate());
-    
-    // Init high cut filter chain
-    auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
-    
-    // Updating the cut filter DSP from the GUI settings
-    updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-    updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+    coefficientDesigner->setPublishNotifier(notifier);
 }
 
-// Function updating all the filters
-void SimplyQueueAudioProcessor::updateFilters()
+void SimplyQueueAudioProcessor::setSmoothingSubBlockSize(int numSamples)
 {
-    // Using helper function of the struct getChainSettings
-    auto chainSettings = getChainSettings(apvts);
-    
-    // Updating all filters from the GUI parameters
-    updateLowCutFilters(chainSettings);
-    updateHighCutFilters(chainSettings);
-    updatePeakFilter(chainSettings);
+    smoothingSubBlockSize = juce::jlimit(16, 64, numSamples);
 }
 
 
 juce::AudioProcessorValueTreeState::ParameterLayout SimplyQueueAudioProcessor::createParameterLayout()
 {
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Low-Cut Freq", "Low-Cut Freq", juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0, 0.25f), 20.0f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>("High-Cut Freq", "High-Cut Freq", juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0, 0.25f), 20000.0f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Freq", "Peak Freq", juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0, 0.25f), 750.0f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Gain", "Peak Gain", juce::NormalisableRange<float>(-24.0f, 24.0f, 0.5f, 1.0f), 0.0f)); // Norma range 0.5 = change of half of a decibel
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Q", "Peak Q", juce::NormalisableRange<float>(0.1f, 10.0f, 0.05f, 1.0f), 1.0f));
-    
-    
-    juce::StringArray dbStringArray;
-    for (int i = 0; i < 4; i++)
-    {
-        juce::String str;
-        str << (12 + i*12);
-        str << "db/Oct";
-        dbStringArray.add(str);
-    }
-    
-    // Choice of slopes for the LPF
-    layout.add(std::make_unique<juce::AudioParameterChoice>("Low-Cut Slope", "Low-Cut Slope", dbStringArray, 0));
-    
-    // Choice of slopes for the HPF
-    layout.add(std::make_unique<juce::AudioParameterChoice>("High-Cut Slope", "High-Cut Slope", dbStringArray, 0));
-    
-    return layout;
+    // Ranges, defaults and choices are all in parameterTable (Parameters.h)
+    return createParameterLayoutFromTable();
 }
 
 
@@ -9,131 +9,23 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "FilterChain.h"
+#include "CoefficientSmoother.h"
+#include "SIMDChain.h"
+#include "PipelinedChain.h"
+#include "LinearPhaseFilter.h"
+#include "LoadMeter.h"
+#include "SpectrumAnalyzer.h"
 
-
-//==============================================================================
-
-// Enum to express the slope settings
-enum SlopeSettings
-{
-    Slope_12,
-    Slope_24,
-    Slope_36,
-    Slope_48
-};
-
-
-// Extracting parameters of apvts, data structure representing all parameters values
-// Parameters from parameterValueTreeState
-struct ChainSettings
-{
-    float peakFreq {0}, peakGainInDecibels {0}, peakQuality {1.0f};
-    float lowCutFreq {0}, highCutFreq {0};
-    
-    // Init the cut by the 12db filter
-    SlopeSettings lowCutSlope {SlopeSettings::Slope_12}, highCutSlope {SlopeSettings::Slope_12};
-};
-
-// Helper function giving all the values to the data struct above
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
-
-using Filter = juce::dsp::IIR::Filter<float>; // Creating a juce dsp filter 'type alias'
-
-// We want cutfilter to have a max of 48db reponse. Each filter are 12db response, so we need to
-// 'side-chain' 4 of them to obtain this selectable 12db-48db. We do this using a processor chain.
-// We pass the processor a single context (audio samples) for the 4 filters.
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
-
-// Mono chain: Low cut --> Parametric --> High cut
-// We create a mono chain by having 2 cut filters for the low&high cut
-// and a normal filter for parametric
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
-
-// Enum representing each filter in the chain. Goes along with the MonoChain above defining each:
-// cut filter, filter, cut filter
-enum ChainPositions
-{
-    LowCut,
-    Peak,
-    HighCut
-};
-
-// -------------------------------------------------------------------------------------------------------
-// All of these update functions are public as 'free' functions, to be utilised by the plugin editor.
-// --> If they use member variables, they need to become function arguments.
-// -------------------------------------------------------------------------------------------------------
-
-
-// Juce coefficient Alias
-using Coefficients = Filter::CoefficientsPtr;
-
-// Helper function to update peak filter coefficients
-void updateCoefficients(Coefficients& old, const Coefficients& replacements);
-
-Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate);
-
-// Template function
-template<int Index, typename ChainType, typename CoefficientType>
-void update(ChainType& chain, const CoefficientType& coefficients)
-{
-    updateCoefficients(chain.template get<Index>().coefficients, coefficients[Index]);
-    chain.template setBypassed<Index> (false);
-}
-
-// Low/high cut filter coefficient update
-template<typename ChainType, typename CoefficientType>
-void updateCutFilter(ChainType& leftLowCut,
-                     const CoefficientType& cutCoefficients,
-                     const SlopeSettings& lowCutSlope)
-{
-    
-    // Bypass all link in chain
-    leftLowCut.template setBypassed<0>(true);
-    leftLowCut.template setBypassed<1>(true);
-    leftLowCut.template setBypassed<2>(true);
-    leftLowCut.template setBypassed<3>(true);
-    
-    // Updates filter coefficients depending on which slope is selected
-    switch (lowCutSlope)
-    {
-        // Reversing case order and removing breaks to avoid duplicate code
-        case Slope_48:
-        {
-            update<3>(leftLowCut, cutCoefficients);
-        }
-        case Slope_36:
-        {
-            update<2>(leftLowCut, cutCoefficients);
-        }
-        case Slope_24:
-        {
-            update<1>(leftLowCut, cutCoefficients);
-        }
-        case Slope_12:
-        {
-            update<0>(leftLowCut, cutCoefficients);
-        }
-    }
-}
-
-inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate)
-{
-    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq,
-                                                                                       sampleRate,
-                                                                                       (chainSettings.lowCutSlope + 1) * 2);
-}
-
-inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate)
-{
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq,
-                                                                                      sampleRate,
-                                                                                      (chainSettings.highCutSlope + 1) * 2);
-}
+class CoefficientDesigner;
+struct CoefficientSnapshot;
 
 //==============================================================================
 /**
 */
-class SimplyQueueAudioProcessor  : public juce::AudioProcessor
+class SimplyQueueAudioProcessor  : public juce::AudioProcessor,
+                                    private juce::AudioProcessorValueTreeState::Listener,
+                                    private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -149,6 +41,10 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    
+    // 64 bit hosts hand us their double buffers directly, no conversion to float and back
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -178,22 +74,172 @@ public:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout(); // Static as it doesn't use any member variable
     
     juce::AudioProcessorValueTreeState apvts {*this, nullptr, "Parameters", createParameterLayout()}; //Binding GUI control to the DSP in processor
+    
+    // Every parameter value read by index (see parameterTable), looked up once
+    const ParameterValues parameterValues {apvts};
+    
+    // Coefficient ramps advance on a fixed grid of sub-blocks, whatever the host buffer size.
+    // Size in samples, clamped to [16, 64]. Safe to call from any thread.
+    void setSmoothingSubBlockSize(int numSamples);
+    int getSmoothingSubBlockSize() const { return smoothingSubBlockSize.load(); }
+    
+    // Cost of the smoothing: number of coefficient updates done in the last block.
+    // Capped at ceil(blockSize / subBlockSize), and 0 once the ramps are done.
+    int getCoefficientUpdatesInLastBlock() const { return coefficientUpdatesInLastBlock.load(); }
+    
+    // Memory of the precomputed cut filter table for the current sample rate, in bytes
+    size_t getCutFilterTableMemory() const;
+    
+    // How the channels go through the filters: one MonoChain per channel, all the channels at once
+    // in the lanes of a SIMD register, or one channel at a time with consecutive sections in the
+    // lanes (for mono and dual mono). Can be switched at any time, for A/B comparisons.
+    enum class ProcessingPath
+    {
+        monoChains,
+        simdLanes,
+        pipelinedSections
+    };
+    
+    void setProcessingPath(ProcessingPath newPath) { processingPath = newPath; }
+    ProcessingPath getProcessingPath() const { return processingPath.load(); }
+    
+    // Bands changing the gain by less than this many decibels across the audible range are skipped
+    // (e.g. the peak at 0db). 0 never skips anything. Safe to call from any thread.
+    void setNeutralBandThreshold(float decibels);
+    float getNeutralBandThreshold() const;
+    
+    // The coefficients the audio thread runs (or picks up on its next block), with the skipped
+    // bands and a version number. For the editor only: there can be a single reader.
+    // pullCoefficientSnapshot() returns true if a newer snapshot was picked up.
+    bool pullCoefficientSnapshot();
+    const CoefficientSnapshot& getCoefficientSnapshot() const;
+    
+    // Triggered whenever a new snapshot is published, so the editor never has to poll.
+    // nullptr to stop. Not to be called from the audio thread.
+    void setDesignNotifier(juce::AsyncUpdater* notifier);
+    
+    // Time spent in processBlock, for the editor's DSP load display
+    LoadMeter& getLoadMeter() { return loadMeter; }
+    
+    // Input and output spectra, for the editor's analyser
+    SpectrumAnalyzer& getSpectrumAnalyzer() { return spectrumAnalyzer; }
 
 private:
     
-    // Creating 2 mono chain for stereo processing
-    MonoChain leftChain, rightChain;
+    // The filters of one precision. Only the one the host processes with is prepared.
+    template<typename SampleType>
+    struct ProcessingChains
+    {
+        // One mono chain per channel of the bus (1 for mono, 2 for stereo, 12 for 7.1.4...)
+        std::vector<MonoChainType<SampleType>> monoChains;
+        
+        // Every channel at once, packed into SIMD lanes
+        SIMDChain<SampleType> simdChain;
+        
+        // One channel at a time, the sections of the cascade packed into SIMD lanes
+        PipelinedChain<SampleType> pipelinedChain;
+    };
+    
+    ProcessingChains<float> floatChains;
+    ProcessingChains<double> doubleChains;
+    
+    template<typename SampleType>
+    static void prepareChains(ProcessingChains<SampleType>& chains, juce::dsp::ProcessSpec spec, int numChannels);
+    
+    // processBlock for both precisions: one implementation, only the chains differ
+    template<typename SampleType>
+    void processBlockWith(juce::AudioBuffer<SampleType>& buffer, ProcessingChains<SampleType>& chains);
+    
+    std::atomic<ProcessingPath> processingPath {ProcessingPath::monoChains};
+    ProcessingPath activeProcessingPath {ProcessingPath::monoChains};
+    
+    // Linear phase mode: an FIR replaces the IIR chains while the "Linear Phase" parameter is on.
+    // Declared before the designer, which builds the FIRs on its thread.
+    LinearPhaseFilter linearPhaseFilter;
+    
+    bool linearPhaseActive {false};
+    
+    // Float copy of double buffers, the convolution only runs in float
+    juce::AudioBuffer<float> linearPhaseBuffer;
+    
+    // Longest prepareToPlay waits for the FIR when rendering offline
+    static constexpr int firLoadTimeoutMs = 10000;
+    
+    // FIR length selected by the "FIR Length" parameter
+    int getFirLength() const;
+    
+    // "Linear Phase" as the message thread last saw it: all the audio thread reads of the parameters
+    std::atomic<bool> linearPhaseEnabled {false};
     
-    // Update peak filter with the chain settings
-    void updatePeakFilter(const ChainSettings& chainSettings);
+    // Message thread (or prepareToPlay): follows the linear phase parameters, hands the FIR length to
+    // the filter and reports the latency. Never from the audio thread: setLatencySamples() notifies the host.
+    void updateLinearPhaseSettings();
     
-    // Function update LPF / HPF
-    void updateLowCutFilters(const ChainSettings& chainSettings);
-    void updateHighCutFilters(const ChainSettings& chainSettings);
+    // Listens to "Linear Phase" and "FIR Length" only, the designer follows the other parameters
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
     
-    // Function updating all the filters
+    // Audio thread: picks up the mode set by updateLinearPhaseSettings(). Returns true if it changed.
+    bool updateLinearPhase();
+    
+    // How long the output keeps going once the input stops, in samples: the FIR or the IIR chains.
+    // Both the audio thread (the mode it runs) and the host (the mode the latency is reported for).
+    double getTailLengthInSamples(bool linearPhase) const;
+    
+    template<typename SampleType>
+    void processLinearPhase(juce::AudioBuffer<SampleType>& buffer);
+    
+    // Designs the coefficients on a background thread, whenever the parameters move
+    std::unique_ptr<CoefficientDesigner> coefficientDesigner;
+    
+    // Function picking up the newest coefficients designed in the background, if any
     void updateFilters();
     
+    // Ramps the chains towards the newest designed coefficients
+    CoefficientSmoother coefficientSmoother;
+    
+    static constexpr double smoothingTimeSeconds = 0.02;
+    
+    std::atomic<int> smoothingSubBlockSize {32};
+    std::atomic<int> coefficientUpdatesInLastBlock {0};
+    
+    int activeSubBlockSize {0};              // Sub-block size the ramp length was computed for
+    int samplesUntilCoefficientUpdate {0};   // Position on the sub-block grid, carried across blocks
+    
+    // Updates the ramp length when the sub-block size changed
+    void updateSmoothingRamp();
+    
+    // Copies a coefficient snapshot into every processing path, so they can be switched at any time
+    void updateChains(const ChainCoefficients& chainCoefficients);
+    
+    template<typename SampleType>
+    void updateChains(ProcessingChains<SampleType>& chains, const ChainCoefficients& chainCoefficients);
+    
+    // Sections running in each band for the last snapshot, they pick the cascade specialisation
+    // the mono chains run
+    ActiveSections activeSections;
+    
+    LoadMeter loadMeter;
+    SpectrumAnalyzer spectrumAnalyzer;
+    
+    // Runs the audio of a (sub-)block through the active processing path
+    template<typename SampleType>
+    void processChains(juce::dsp::AudioBlock<SampleType>& block, ProcessingChains<SampleType>& chains);
+    
+    // ------------------------------ Silence --------------------------------------
+    const float silenceThreshold = juce::Decibels::decibelsToGain((float) silenceInDecibels);
+    
+    juce::int64 silentSamples {0}; // Silent input samples in a row, up to the tail length
+    bool isIdle {false};           // True while processing is skipped
+    
+    // True if every sample of the buffer is below silenceThreshold
+    template<typename SampleType>
+    bool isInputSilent(const juce::AudioBuffer<SampleType>& buffer) const;
+    
+    // Clears the filter states of both processing paths
+    template<typename SampleType>
+    static void resetChains(ProcessingChains<SampleType>& chains);
+    
     
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimplyQueueAudioProcessor)
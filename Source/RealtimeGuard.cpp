@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.cpp
+    Debug check that nothing allocates or locks a mutex inside processBlock.
+
+  ==============================================================================
+*/
+
+#include "RealtimeGuard.h"
+
+#if SIMPLYQUEUE_REALTIME_GUARD
+
+namespace RealtimeGuard
+{
+namespace
+{
+    thread_local int scopeDepth = 0;
+    
+    // Set while a violation is being recorded, so the allocations of the report aren't reported
+    thread_local bool isReporting = false;
+    
+    // A loop allocating on every sample would fill the memory with stack traces: only the first ones are kept
+    constexpr size_t maxNumViolations = 64;
+    
+    std::mutex violationsLock;
+    std::vector<Violation> violations;
+}
+
+ScopedRealtimeScope::ScopedRealtimeScope() noexcept   { ++scopeDepth; }
+ScopedRealtimeScope::~ScopedRealtimeScope() noexcept  { --scopeDepth; }
+
+bool isInRealtimeScope() noexcept
+{
+    return scopeDepth > 0 && ! isReporting;
+}
+
+void reportViolation(const char* what)
+{
+    isReporting = true;
+    
+    {
+        const std::lock_guard<std::mutex> lock(violationsLock);
+        
+        if (violations.size() < maxNumViolations)
+            violations.push_back({ what, juce::SystemStats::getStackBacktrace() });
+    }
+    
+    isReporting = false;
+}
+
+std::vector<Violation> getViolations()
+{
+    const std::lock_guard<std::mutex> lock(violationsLock);
+    return violations;
+}
+
+void clearViolations()
+{
+    const std::lock_guard<std::mutex> lock(violationsLock);
+    violations.clear();
+}
+}
+
+#endif
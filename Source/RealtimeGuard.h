@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.h
+    Debug check that nothing allocates or locks a mutex inside processBlock.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Off by default: the plugin is built without any of it. The realtime check tool
+// builds with SIMPLYQUEUE_REALTIME_GUARD=1 and hooks operator new/delete and the
+// mutexes, which report here when they are called inside a realtime scope.
+#ifndef SIMPLYQUEUE_REALTIME_GUARD
+ #define SIMPLYQUEUE_REALTIME_GUARD 0
+#endif
+
+#if SIMPLYQUEUE_REALTIME_GUARD
+
+namespace RealtimeGuard
+{
+    // Something the audio thread must not do, and where it was done from
+    struct Violation
+    {
+        juce::String what;
+        juce::String stackTrace;
+    };
+    
+    // Marks the calling thread as realtime for as long as it exists. Can be nested.
+    struct ScopedRealtimeScope
+    {
+        ScopedRealtimeScope() noexcept;
+        ~ScopedRealtimeScope() noexcept;
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeScope)
+    };
+    
+    // True when the calling thread is inside a realtime scope. Cheap: called by the hooks on every allocation.
+    bool isInRealtimeScope() noexcept;
+    
+    // Records a violation with the stack trace of the calling thread. The report itself
+    // allocates and locks, the hooks don't see that.
+    void reportViolation(const char* what);
+    
+    std::vector<Violation> getViolations();
+    void clearViolations();
+}
+
+ #define SIMPLYQUEUE_REALTIME_SCOPE const RealtimeGuard::ScopedRealtimeScope realtimeScope;
+#else
+ #define SIMPLYQUEUE_REALTIME_SCOPE
+#endif
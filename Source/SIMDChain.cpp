@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+    SIMDChain.cpp
+    Low cut --> Parametric bands --> High cut cascade running several channels at once, one per SIMD lane.
+
+  ==============================================================================
+*/
+
+#include "SIMDChain.h"
+
+//==============================================================================
+template<typename FloatType>
+void SIMDChain<FloatType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    jassert(spec.numChannels > 0 && spec.numChannels <= maxChannels);
+    
+    numChannels = juce::jmin((size_t) spec.numChannels, maxChannels);
+    
+    // Mono never interleaves, it runs on the channel data directly
+    const auto numGroups = numChannels > 1 ? (numChannels + lanes - 1) / lanes : 0;
+    
+    groupStates.resize(numGroups);
+    interleaved.resize(numGroups > 0 ? spec.maximumBlockSize : 0);
+    
+    reset();
+}
+
+template<typename FloatType>
+void SIMDChain<FloatType>::reset() noexcept
+{
+    for (auto& state : groupStates)
+        state = {};
+    
+    monoState = {};
+}
+
+template<typename FloatType>
+template<typename SampleType>
+void SIMDChain<FloatType>::clearSections(CascadeState<SampleType>& state, const ActiveSections& running) noexcept
+{
+    for (auto i = running.lowCut; i < (int) state.lowCut.size(); ++i)
+        state.lowCut[(size_t) i] = {};
+    
+    
+    for (auto i = running.highCut; i < (int) state.highCut.size(); ++i)
+        state.highCut[(size_t) i] = {};
+}
+
+template<typename FloatType>
+void SIMDChain<FloatType>::setCoefficients(const ChainCoefficients& chainCoefficients) noexcept
+{
+    const auto newSections = getActiveSections(chainCoefficients);
+    
+    // Sections that were not running have a stale state, clear it before they come back
+    if (newSections.lowCut > activeSections.lowCut
+        || newSections.highCut > activeSections.highCut)
+    {
+        for (auto& state : groupStates)
+            clearSections(state, activeSections);
+        
+        clearSections(monoState, activeSections);
+    }
+    
+    // The bands that are off always have a clean state: a band coming back starts from it
+    for (auto& state : groupStates)
+        clearStoppedBands(state.bands, chainCoefficients.bandActive);
+    
+    clearStoppedBands(monoState.bands, chainCoefficients.bandActive);
+    
+    activeSections = newSections;
+    
+    auto makeScalar = [](const BiquadCoefficients& c) -> Section<FloatType>
+    {
+        return { static_cast<FloatType>(c.b0), static_cast<FloatType>(c.b1), static_cast<FloatType>(c.b2),
+                 static_cast<FloatType>(c.a1), static_cast<FloatType>(c.a2) };
+    };
+    
+    auto makeVector = [&](const BiquadCoefficients& c) -> Section<Vector>
+    {
+        const auto s = makeScalar(c);
+        
+        return { Vector::expand(s.b0), Vector::expand(s.b1), Vector::expand(s.b2),
+                 Vector::expand(s.a1), Vector::expand(s.a2) };
+    };
+    
+    for (size_t i = 0; i < chainCoefficients.lowCut.size(); ++i)
+    {
+        scalarCoefficients.lowCut[i] = makeScalar(chainCoefficients.lowCut[i]);
+        scalarCoefficients.highCut[i] = makeScalar(chainCoefficients.highCut[i]);
+        vectorCoefficients.lowCut[i] = makeVector(chainCoefficients.lowCut[i]);
+        vectorCoefficients.highCut[i] = makeVector(chainCoefficients.highCut[i]);
+    }
+    
+    // Only the running bands are packed into the slots
+    setBandCascadeCoefficients(scalarCoefficients.bands, chainCoefficients.bands, chainCoefficients.bandActive);
+    setBandCascadeCoefficients(vectorCoefficients.bands, chainCoefficients.bands, chainCoefficients.bandActive);
+}
+
+template<typename FloatType>
+template<typename SampleType>
+void SIMDChain<FloatType>::processCascade(SampleType* samples, size_t numSamples,
+                                          const CascadeCoefficients<SampleType>& coefficients,
+                                          CascadeState<SampleType>& state) const noexcept
+{
+    // One part after the other over the whole block: 5 + 9 + 5 specialisations instead of one per
+    // combination of slopes and number of bands. The block is small enough to stay in the cache.
+    withNumSections(activeSections.lowCut, [&](auto numLowCut)
+    {
+        processCutCascade<decltype(numLowCut)::value>(samples, numSamples, coefficients.lowCut, state.lowCut);
+    });
+    
+    // Same kernel as the MonoChain's bands: on a SIMD register it filters a whole group of channels
+    withNumBands(coefficients.bands.numActive, [&](auto numBands)
+    {
+        processBandCascade<decltype(numBands)::value>(samples, numSamples, coefficients.bands, state.bands);
+    });
+    
+    withNumSections(activeSections.highCut, [&](auto numHighCut)
+    {
+        processCutCascade<decltype(numHighCut)::value>(samples, numSamples, coefficients.highCut, state.highCut);
+    });
+}
+
+template<typename FloatType>
+template<int NumSections, typename SampleType>
+void SIMDChain<FloatType>::processCutCascade(SampleType* samples, size_t numSamples,
+                                             const std::array<Section<SampleType>, 4>& sections,
+                                             std::array<State<SampleType>, 4>& states) noexcept
+{
+    static_assert(NumSections >= 0 && NumSections <= 4, "A cut filter has 1 to 4 sections, or none when skipped");
+    
+    if constexpr (NumSections > 0)
+    {
+        // The states are kept in a local so they can live in registers for the whole block
+        auto local = states;
+        
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            auto sample = samples[n];
+            
+            for (size_t i = 0; i < (size_t) NumSections; ++i)
+                sample = processSection(sections[i], local[i], sample);
+            
+            samples[n] = sample;
+        }
+        
+        states = local;
+    }
+}
+
+template<typename FloatType>
+void SIMDChain<FloatType>::process(const juce::dsp::AudioBlock<FloatType>& block) noexcept
+{
+    // Every band is neutral: the audio goes through untouched, no need to even interleave it
+    if (activeSections.lowCut + activeSections.bands + activeSections.highCut == 0)
+        return;
+    
+    const auto blockChannels = juce::jmin(block.getNumChannels(), numChannels);
+    
+    // Mono fast path: scalar cascade straight on the channel, nothing to interleave
+    if (numChannels == 1)
+    {
+        if (blockChannels == 1)
+            processCascade(block.getChannelPointer(0), block.getNumSamples(), scalarCoefficients, monoState);
+        
+        return;
+    }
+    
+    if (interleaved.empty())
+        return;
+    
+    // Some hosts go over the block size they announced: the block goes through in chunks the
+    // interleaving buffer can hold, like the sub-blocks of processBlock
+    const auto numSamples = block.getNumSamples();
+    
+    for (size_t start = 0; start < numSamples; start += interleaved.size())
+        processGroups(block.getSubBlock(start, juce::jmin(interleaved.size(), numSamples - start)), blockChannels);
+}
+
+template<typename FloatType>
+void SIMDChain<FloatType>::processGroups(const juce::dsp::AudioBlock<FloatType>& block, size_t blockChannels) noexcept
+{
+    const auto numSamples = block.getNumSamples();
+    jassert(numSamples <= interleaved.size());
+    
+    auto* frames = reinterpret_cast<FloatType*>(interleaved.data());
+    
+    for (size_t group = 0; group < groupStates.size(); ++group)
+    {
+        const auto firstChannel = group * lanes;
+        
+        if (firstChannel >= blockChannels)
+            break;
+        
+        const auto groupChannels = juce::jmin(lanes, blockChannels - firstChannel);
+        
+        // Interleave: lane c of frame n is sample n of channel c, unused lanes stay silent
+        if (groupChannels < lanes)
+            for (size_t n = 0; n < numSamples; ++n)
+                interleaved[n] = Vector::expand(FloatType(0));
+        
+        for (size_t lane = 0; lane < groupChannels; ++lane)
+        {
+            const auto* samples = block.getChannelPointer(firstChannel + lane);
+            
+            for (size_t n = 0; n < numSamples; ++n)
+                frames[n * lanes + lane] = samples[n];
+        }
+        
+        processCascade(interleaved.data(), numSamples, vectorCoefficients, groupStates[group]);
+        
+        // De-interleave back into the block
+        for (size_t lane = 0; lane < groupChannels; ++lane)
+        {
+            auto* samples = block.getChannelPointer(firstChannel + lane);
+            
+            for (size_t n = 0; n < numSamples; ++n)
+                samples[n] = frames[n * lanes + lane];
+        }
+    }
+}
+
+// Single and double precision processing
+template class SIMDChain<float>;
+template class SIMDChain<double>;
@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    SIMDChain.h
+    Low cut --> Parametric bands --> High cut cascade running several channels at once, one per SIMD lane.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+//==============================================================================
+/**
+    Same filters as a MonoChain, for any number of channels from 1 to maxChannels.
+ 
+    The channels are interleaved into the lanes of a juce::dsp::SIMDRegister<float>,
+    so a single pass of the cascade filters a whole group of channels (4 or 8 of them
+    depending on the CPU). Stereo uses 2 lanes of one register, 7.1.4 uses 3 registers
+    on SSE/NEON. Mono skips the interleaving and runs the scalar cascade in place.
+ 
+    Every biquad is a transposed direct form II, computed in the same order as
+    juce::dsp::IIR::Filter, so each lane gives the same result as a MonoChain would.
+ 
+    FloatType is float or double: a double chain has half as many lanes per register.
+*/
+template<typename FloatType>
+class SIMDChain
+{
+public:
+    using Vector = juce::dsp::SIMDRegister<FloatType>;
+    
+    // Number of channels filtered by one pass of the cascade
+    static constexpr size_t lanes = Vector::SIMDNumElements;
+    
+    static constexpr size_t maxChannels = maxNumChannels;
+    
+    SIMDChain() = default;
+    
+    // Allocates the states and the interleaving buffer for spec.numChannels channels
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    
+    // Clears the state of every section
+    void reset() noexcept;
+    
+    // Copies a designed snapshot into the chain (no allocation). Sections coming back
+    // into use, when the slope goes up or a skipped band returns, start from a clean state.
+    void setCoefficients(const ChainCoefficients& chainCoefficients) noexcept;
+    
+    // Filters the channels of the block in place (at most the number it was prepared with)
+    void process(const juce::dsp::AudioBlock<FloatType>& block) noexcept;
+    
+private:
+    // Coefficients of one biquad. For the SIMD groups they are copied in every lane.
+    template<typename SampleType>
+    struct Section
+    {
+        SampleType b0, b1, b2, a1, a2;
+    };
+    
+    // Transposed direct form II state, one value per lane
+    template<typename SampleType>
+    struct State
+    {
+        SampleType lv1 {}, lv2 {};
+    };
+    
+    // The bands use the same structure of arrays as the MonoChain's (see ParametricBands.h)
+    template<typename SampleType>
+    struct CascadeCoefficients
+    {
+        std::array<Section<SampleType>, 4> lowCut, highCut;
+        BandCascadeCoefficients<SampleType> bands;
+    };
+    
+    template<typename SampleType>
+    struct CascadeState
+    {
+        std::array<State<SampleType>, 4> lowCut, highCut;
+        BandCascadeState<SampleType> bands;
+    };
+    
+    template<typename SampleType>
+    static inline SampleType processSection(const Section<SampleType>& s, State<SampleType>& state, SampleType input) noexcept
+    {
+        auto output = input * s.b0 + state.lv1;
+        state.lv1 = (input * s.b1) - (output * s.a1) + state.lv2;
+        state.lv2 = (input * s.b2) - (output * s.a2);
+        return output;
+    }
+    
+    // Runs the whole cascade over the samples (or interleaved frames) in place: the low cut,
+    // the bands, then the high cut, each over the whole block. Every part picks the specialisation
+    // matching its number of sections, once per call.
+    template<typename SampleType>
+    void processCascade(SampleType* samples, size_t numSamples,
+                        const CascadeCoefficients<SampleType>& coefficients,
+                        CascadeState<SampleType>& state) const noexcept;
+    
+    // A cut filter with a fixed number of sections: the loop over the sections has a constant
+    // trip count and unrolls, there is no branch left in the per sample loop
+    template<int NumSections, typename SampleType>
+    static void processCutCascade(SampleType* samples, size_t numSamples,
+                                  const std::array<Section<SampleType>, 4>& sections,
+                                  std::array<State<SampleType>, 4>& states) noexcept;
+    
+    // Interleaves, filters and de-interleaves blockChannels channels, at most interleaved.size() samples
+    void processGroups(const juce::dsp::AudioBlock<FloatType>& block, size_t blockChannels) noexcept;
+    
+    // Clears the state of every cut section that is not part of 'running', and of the bands that are off
+    template<typename SampleType>
+    static void clearSections(CascadeState<SampleType>& state, const ActiveSections& running) noexcept;
+    
+    CascadeCoefficients<Vector> vectorCoefficients;
+    CascadeCoefficients<FloatType> scalarCoefficients;
+    
+    // One state per group of 'lanes' channels, and the state of the mono fast path
+    std::vector<CascadeState<Vector>> groupStates;
+    CascadeState<FloatType> monoState;
+    
+    size_t numChannels {0};
+    
+    // Number of biquads running in each cut, and number of bands running
+    ActiveSections activeSections;
+    
+    // One register per sample frame, reused by every group
+    std::vector<Vector> interleaved;
+    
+    JUCE_LEAK_DETECTOR (SIMDChain)
+};
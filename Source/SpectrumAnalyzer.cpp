@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.cpp
+    Spectrum of the input and the output, drawn behind the response curve.
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyzer.h"
+#include "Tracer.h"
+
+#if SIMPLYQUEUE_SPECTRUM_ANALYZER
+
+//==============================================================================
+SpectrumAnalyzer::SpectrumAnalyzer() : juce::Thread("SimplyQueue spectrum")
+{
+    input.levels.fill(minDecibels);
+    output.levels.fill(minDecibels);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    stopThread(1000);
+}
+
+void SpectrumAnalyzer::setActive(bool shouldBeActive, juce::AsyncUpdater* pathsReady)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (shouldBeActive == isActive())
+        return;
+
+    if (shouldBeActive)
+    {
+        // The worker is stopped, so this is the only reader. What is left from the last
+        // time the spectrum was shown is out of date.
+        for (auto* tap : { &input, &output })
+        {
+            tap->fifo.finishedRead(tap->fifo.getNumReady());
+            tap->levels.fill(minDecibels);
+        }
+
+        pathsReadyUpdater = pathsReady;
+
+        active.store(true, std::memory_order_relaxed);
+        startThread();
+    }
+    else
+    {
+        active.store(false, std::memory_order_relaxed);
+        stopThread(1000);
+
+        pathsReadyUpdater = nullptr;
+    }
+}
+
+void SpectrumAnalyzer::setDisplaySize(int width, int height) noexcept
+{
+    displayWidth.store(width);
+    displayHeight.store(height);
+}
+
+bool SpectrumAnalyzer::pullPaths(juce::Path& inputPath, juce::Path& outputPath)
+{
+    if (! newPathsReady.exchange(false))
+        return false;
+
+    // Swapping keeps the memory of both sides, nothing is allocated once the paths have grown
+    const juce::ScopedLock lock(pathLock);
+    inputPath.swapWithPath(readyInputPath);
+    outputPath.swapWithPath(readyOutputPath);
+
+    return true;
+}
+
+//==============================================================================
+void SpectrumAnalyzer::run()
+{
+    while (! threadShouldExit())
+    {
+        const auto currentSampleRate = sampleRate.load();
+
+        if (currentSampleRate != binRangesSampleRate)
+            updateBinRanges(currentSampleRate);
+
+        // Both taps are read every time, whichever has new samples
+        const auto inputChanged = readTap(input);
+        const auto outputChanged = readTap(output);
+
+        if (inputChanged || outputChanged)
+        {
+            buildPath(input, true);
+            buildPath(output, false);
+
+            {
+                const juce::ScopedLock lock(pathLock);
+                input.path.swapWithPath(readyInputPath);
+                output.path.swapWithPath(readyOutputPath);
+            }
+
+            newPathsReady.store(true);
+
+            if (pathsReadyUpdater != nullptr)
+                pathsReadyUpdater->triggerAsyncUpdate();
+        }
+
+        // About one screen refresh
+        wait(15);
+    }
+}
+
+bool SpectrumAnalyzer::readTap(Tap& tap)
+{
+    // Fell behind (the machine is busy): skip what could not be shown in time anyway
+    const auto excess = tap.fifo.getNumReady() - fftSize;
+
+    if (excess > 0)
+        tap.fifo.finishedRead(excess);
+
+    auto changed = false;
+
+    // One spectrum every hopSize samples, over the last fftSize samples
+    while (tap.fifo.getNumReady() >= hopSize)
+    {
+        std::move(tap.history.begin() + hopSize, tap.history.end(), tap.history.begin());
+
+        auto* destination = tap.history.data() + fftSize - hopSize;
+        const auto scope = tap.fifo.read(hopSize);
+        scope.forEach([&](int index) { *destination++ = tap.samples[(size_t) index]; });
+
+        analyse(tap);
+        changed = true;
+    }
+
+    return changed;
+}
+
+void SpectrumAnalyzer::analyse(Tap& tap)
+{
+    const Tracer::ScopedEvent traceEvent("spectrum FFT", fftSize);
+
+    std::copy(tap.history.begin(), tap.history.end(), fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), (size_t) fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    // A full scale sine peaks at fftSize / 4 with the Hann window: scaled to 0dB
+    const auto normalisation = 4.0f / (float) fftSize;
+    const auto release = (float) (releaseDecibelsPerSecond * hopSize / binRangesSampleRate);
+
+    for (int point = 0; point < numDisplayPoints; ++point)
+    {
+        // Highest bin under the point: at high frequencies a point covers many bins,
+        // at low frequencies neighbouring points share one
+        const auto firstBin = binEdges[(size_t) point];
+        const auto lastBin = juce::jmax(binEdges[(size_t) point + 1], firstBin + 1);
+
+        auto magnitude = 0.0f;
+
+        for (int bin = firstBin; bin < lastBin; ++bin)
+            magnitude = juce::jmax(magnitude, fftData[(size_t) bin]);
+
+        // Rises straight away, falls back slowly so the display doesn't flicker
+        const auto level = juce::Decibels::gainToDecibels(magnitude * normalisation, minDecibels);
+        tap.levels[(size_t) point] = juce::jmax(level, tap.levels[(size_t) point] - release);
+    }
+}
+
+void SpectrumAnalyzer::updateBinRanges(double newSampleRate)
+{
+    binRangesSampleRate = newSampleRate;
+
+    const auto binWidth = newSampleRate / fftSize;
+
+    // Edges half way (on the log scale) between the display points
+    for (int edge = 0; edge <= numDisplayPoints; ++edge)
+    {
+        const auto frequency = juce::mapToLog10((edge - 0.5) / (numDisplayPoints - 1), 20.0, 20000.0);
+        binEdges[(size_t) edge] = juce::jlimit(1, fftSize / 2, (int) (frequency / binWidth + 0.5));
+    }
+}
+
+void SpectrumAnalyzer::buildPath(Tap& tap, bool closed)
+{
+    // Clearing keeps the memory of the path
+    tap.path.clear();
+
+    const auto width = (float) displayWidth.load();
+    const auto height = (float) displayHeight.load();
+
+    if (width <= 0.0f || height <= 0.0f)
+        return;
+
+    auto x = [width](int point) { return width * (float) point / (float) (numDisplayPoints - 1); };
+    auto y = [height](float level) { return juce::jmap(level, minDecibels, maxDecibels, height, 0.0f); };
+
+    tap.path.startNewSubPath(x(0), y(tap.levels[0]));
+
+    for (int point = 1; point < numDisplayPoints; ++point)
+        tap.path.lineTo(x(point), y(tap.levels[(size_t) point]));
+
+    // Down to the bottom and back, to be filled
+    if (closed)
+    {
+        tap.path.lineTo(width, height);
+        tap.path.lineTo(0.0f, height);
+        tap.path.closeSubPath();
+    }
+}
+
+#endif
@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.h
+    Spectrum of the input and the output, drawn behind the response curve.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// On by default. Build with SIMPLYQUEUE_SPECTRUM_ANALYZER=0 and processBlock doesn't feed
+// anything, and the editor only shows the response curve.
+#ifndef SIMPLYQUEUE_SPECTRUM_ANALYZER
+ #define SIMPLYQUEUE_SPECTRUM_ANALYZER 1
+#endif
+
+#if SIMPLYQUEUE_SPECTRUM_ANALYZER
+
+//==============================================================================
+/**
+    The audio thread copies its blocks (mixed down to mono) into two lock-free single
+    producer / single consumer FIFOs, one before and one after the filters. A worker
+    thread reads them, runs the windowed FFTs, groups the bins on a log frequency scale
+    and builds the paths. The message thread only picks the paths up and draws them.
+
+    The worker only runs while an editor is open. Otherwise the audio thread checks one
+    atomic flag per block and copies nothing. When a FIFO is full (the worker is late),
+    the samples that don't fit are dropped instead of waiting.
+*/
+class SpectrumAnalyzer : private juce::Thread
+{
+public:
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer() override;
+
+    //==============================================================================
+    // Audio thread side
+
+    void prepare(double newSampleRate) noexcept { sampleRate.store(newSampleRate); }
+
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    /**
+        Feeds one processBlock call: the input when it is created, the output when it goes
+        out of scope (early returns included).
+    */
+    template<typename SampleType>
+    class BlockTap
+    {
+    public:
+        BlockTap(SpectrumAnalyzer& spectrumAnalyzer, juce::AudioBuffer<SampleType>& audioBuffer) noexcept
+            : analyzer(spectrumAnalyzer),
+              buffer(audioBuffer),
+              enabled(spectrumAnalyzer.isActive())
+        {
+            if (enabled)
+                push(analyzer.input, buffer);
+        }
+
+        ~BlockTap()
+        {
+            if (enabled)
+                push(analyzer.output, buffer);
+        }
+
+    private:
+        SpectrumAnalyzer& analyzer;
+        juce::AudioBuffer<SampleType>& buffer;
+        const bool enabled;
+
+        JUCE_DECLARE_NON_COPYABLE(BlockTap)
+    };
+
+    //==============================================================================
+    // Editor side (message thread)
+
+    // Starts the worker and the copies on the audio thread, or stops both. While active, the
+    // worker triggers pathsReady (if any) every time it built new paths.
+    void setActive(bool shouldBeActive, juce::AsyncUpdater* pathsReady = nullptr);
+
+    // Size of the area the paths are drawn in, the next paths are built for it
+    void setDisplaySize(int width, int height) noexcept;
+
+    // Swaps in the newest paths if the worker built new ones since the last call.
+    // The input is a closed shape to fill, the output a line to stroke.
+    bool pullPaths(juce::Path& inputPath, juce::Path& outputPath);
+
+private:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;   // 11.7Hz per bin at 48kHz
+    static constexpr int hopSize = fftSize / 4;     // 47 spectra a second at 48kHz
+    static constexpr int fifoSize = 1 << 15;        // 0.68s at 48kHz, plenty for a worker waking up every 15ms
+
+    static constexpr int numDisplayPoints = 256;    // Log spaced from 20Hz to 20kHz
+    static constexpr float minDecibels = -90.0f, maxDecibels = 6.0f;
+    static constexpr float releaseDecibelsPerSecond = 48.0f;
+
+    // One FIFO and the worker's state for each side of the filters
+    struct Tap
+    {
+        juce::AbstractFifo fifo { fifoSize };
+        std::vector<float> samples = std::vector<float>((size_t) fifoSize);
+
+        // Worker thread only
+        std::vector<float> history = std::vector<float>((size_t) fftSize);   // Last fftSize samples read
+        std::array<float, numDisplayPoints> levels;                          // Decibels, with release
+        juce::Path path;
+    };
+
+    Tap input, output;
+
+    template<typename SampleType>
+    static void push(Tap& tap, const juce::AudioBuffer<SampleType>& buffer) noexcept
+    {
+        const auto numChannels = buffer.getNumChannels();
+
+        if (numChannels == 0)
+            return;
+
+        const auto* const* channels = buffer.getArrayOfReadPointers();
+        const auto gain = 1.0f / (float) numChannels;
+
+        // Only what fits is written, the rest of the block is dropped
+        const auto scope = tap.fifo.write(buffer.getNumSamples());
+        auto sample = 0;
+
+        scope.forEach([&](int index)
+        {
+            auto sum = 0.0f;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                sum += (float) channels[channel][sample];
+
+            tap.samples[(size_t) index] = sum * gain;
+            ++sample;
+        });
+    }
+
+    //==============================================================================
+    // Worker thread
+    void run() override;
+
+    // Reads the new samples of a tap, returns true if its levels changed
+    bool readTap(Tap& tap);
+    void analyse(Tap& tap);
+    void buildPath(Tap& tap, bool closed);
+
+    // Bins of the FFT each display point covers, for the current sample rate
+    void updateBinRanges(double newSampleRate);
+
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t) fftSize, juce::dsp::WindowingFunction<float>::hann, false };
+    std::vector<float> fftData = std::vector<float>((size_t) fftSize * 2);
+
+    std::array<int, numDisplayPoints + 1> binEdges;
+    double binRangesSampleRate { 0.0 };
+
+    //==============================================================================
+    std::atomic<bool> active { false };
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<int> displayWidth { 0 }, displayHeight { 0 };
+
+    // Handing the paths over: the worker swaps its new paths in, the message thread swaps them out
+    juce::CriticalSection pathLock;
+    juce::Path readyInputPath, readyOutputPath;
+    std::atomic<bool> newPathsReady { false };
+
+    // Only changed while the worker is stopped
+    juce::AsyncUpdater* pathsReadyUpdater { nullptr };
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrumAnalyzer)
+};
+
+#else
+
+// Compiled out: the same interface, doing nothing, so processBlock doesn't need any #if
+class SpectrumAnalyzer
+{
+public:
+    void prepare(double) noexcept {}
+
+    template<typename SampleType>
+    class BlockTap
+    {
+    public:
+        BlockTap(SpectrumAnalyzer&, juce::AudioBuffer<SampleType>&) noexcept {}
+    };
+};
+
+#endif
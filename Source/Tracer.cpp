@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    Tracer.cpp
+    Timestamped events of the hot paths, exported as a Chrome / Perfetto trace.
+
+  ==============================================================================
+*/
+
+#include "Tracer.h"
+
+#if SIMPLYQUEUE_TRACING
+
+//==============================================================================
+Tracer Tracer::instance;
+
+void Tracer::setEnabled(bool shouldBeEnabled)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (shouldBeEnabled)
+        for (auto& buffer : threadBuffers)
+            if (buffer.events == nullptr)
+                buffer.events = std::make_unique<Event[]>((size_t) eventsPerThread);
+
+    // Release: a thread seeing enabled also sees the buffers
+    enabled.store(shouldBeEnabled, std::memory_order_release);
+}
+
+Tracer::ThreadBuffer* Tracer::getThreadBuffer() noexcept
+{
+    // No thread_local: in a plugin loaded at runtime its first use on a thread can allocate.
+    // Looking through the few buffers is cheap enough.
+    const auto threadId = juce::Thread::getCurrentThreadId();
+
+    for (auto& buffer : threadBuffers)
+        if (buffer.owner.load(std::memory_order_relaxed) == threadId)
+            return &buffer;
+
+    // First event of this thread: claim a free buffer
+    for (auto& buffer : threadBuffers)
+    {
+        juce::Thread::ThreadID expected = nullptr;
+
+        if (buffer.owner.compare_exchange_strong(expected, threadId))
+            return &buffer;
+    }
+
+    return nullptr;
+}
+
+void Tracer::addEvent(const char* name, juce::int64 startTicks, juce::int64 endTicks, juce::int64 value) noexcept
+{
+    if (! isEnabled())
+        return;
+
+    auto* buffer = getThreadBuffer();
+
+    if (buffer == nullptr)
+    {
+        ++numDroppedEvents;
+        return;
+    }
+
+    // Only this thread writes to its buffer
+    const auto index = buffer->numWritten.load(std::memory_order_relaxed);
+    buffer->events[(size_t) (index % eventsPerThread)] = { name, startTicks, endTicks, value };
+    buffer->numWritten.store(index + 1, std::memory_order_release);
+}
+
+//==============================================================================
+juce::String Tracer::exportChromeJson() const
+{
+    juce::MemoryOutputStream json;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    auto toMicroseconds = [](juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+    };
+
+    auto first = true;
+
+    for (size_t thread = 0; thread < threadBuffers.size(); ++thread)
+    {
+        const auto& buffer = threadBuffers[thread];
+
+        if (buffer.events == nullptr || buffer.owner.load() == nullptr)
+            continue;
+
+        // The oldest events may be getting overwritten right now, skip a few of them
+        const auto numWritten = buffer.numWritten.load(std::memory_order_acquire);
+        const auto begin = numWritten > (juce::uint64) eventsPerThread ? numWritten - eventsPerThread + 64 : 0;
+
+        for (auto index = begin; index < numWritten; ++index)
+        {
+            const auto& event = buffer.events[(size_t) (index % eventsPerThread)];
+
+            json << (first ? "" : ",") << "\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (int) thread + 1
+                 << ",\"ts\":" << juce::String(toMicroseconds(event.startTicks), 3)
+                 << ",\"dur\":" << juce::String(toMicroseconds(event.endTicks - event.startTicks), 3)
+                 << ",\"args\":{\"value\":" << event.value << "}}";
+
+            first = false;
+        }
+    }
+
+    json << "\n],\"otherData\":{\"droppedEvents\":" << numDroppedEvents.load() << "}}\n";
+    return json.toString();
+}
+
+bool Tracer::writeChromeJson(const juce::File& file) const
+{
+    return file.replaceWithText(exportChromeJson());
+}
+
+#endif
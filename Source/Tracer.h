@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    Tracer.h
+    Timestamped events of the hot paths, exported as a Chrome / Perfetto trace.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// On by default, but nothing is recorded until tracing is switched on. Build with
+// SIMPLYQUEUE_TRACING=0 to remove the events completely.
+#ifndef SIMPLYQUEUE_TRACING
+ #define SIMPLYQUEUE_TRACING 1
+#endif
+
+#if SIMPLYQUEUE_TRACING
+
+//==============================================================================
+/**
+    One recorder for the whole process, so the events of every instance and every
+    thread end up on the same timeline.
+
+    Each thread writes into its own ring buffer, allocated up front when tracing is
+    switched on for the first time. Recording an event takes no lock and never
+    allocates: the first event of a thread claims a free buffer with a compare and
+    swap, the following ones only write into it. When the buffer is full the oldest
+    events are overwritten, when no buffer is left the events of that thread are
+    dropped.
+
+    The JSON can be loaded in chrome://tracing or https://ui.perfetto.dev
+*/
+class Tracer
+{
+public:
+    static Tracer& getInstance() noexcept { return instance; }
+
+    // Message thread. The first call with true allocates the buffers.
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_acquire); }
+
+    // Any thread. The name has to be a string literal: only the pointer is kept.
+    void addEvent(const char* name, juce::int64 startTicks, juce::int64 endTicks, juce::int64 value) noexcept;
+
+    // Everything still in the buffers, as Chrome trace event JSON. Best called once the
+    // traced threads are quiet: a thread writing at the same time can tear its oldest event.
+    juce::String exportChromeJson() const;
+    bool writeChromeJson(const juce::File& file) const;
+
+    //==============================================================================
+    // Records one complete event spanning its lifetime, with an optional number shown as its argument
+    class ScopedEvent
+    {
+    public:
+        explicit ScopedEvent(const char* eventName, juce::int64 eventValue = 0) noexcept
+            : name(eventName),
+              value(eventValue),
+              startTicks(getInstance().isEnabled() ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~ScopedEvent()
+        {
+            if (startTicks != 0)
+                getInstance().addEvent(name, startTicks, juce::Time::getHighResolutionTicks(), value);
+        }
+
+    private:
+        const char* name;
+        juce::int64 value;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedEvent)
+    };
+
+private:
+    Tracer() = default;
+
+    // Built when the library is loaded, so the first event never pays for it
+    static Tracer instance;
+
+    struct Event
+    {
+        const char* name;
+        juce::int64 startTicks, endTicks, value;
+    };
+
+    struct ThreadBuffer
+    {
+        std::atomic<juce::Thread::ThreadID> owner {nullptr};
+        std::atomic<juce::uint64> numWritten {0};
+        std::unique_ptr<Event[]> events;
+    };
+
+    static constexpr int maxNumThreads = 16;
+    static constexpr int eventsPerThread = 1 << 15;
+
+    ThreadBuffer* getThreadBuffer() noexcept;
+
+    std::array<ThreadBuffer, maxNumThreads> threadBuffers;
+    std::atomic<bool> enabled {false};
+    std::atomic<int> numDroppedEvents {0};
+};
+
+#else
+
+// Compiled out: the same interface for the places that record, doing nothing
+class Tracer
+{
+public:
+    class ScopedEvent
+    {
+    public:
+        explicit ScopedEvent(const char*, juce::int64 = 0) noexcept {}
+    };
+};
+
+#endif
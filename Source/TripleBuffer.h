@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Wait-free hand over of a value from one producer thread to one consumer thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Three copies of a value: one being written by the producer, one being read by
+    the consumer, and one in the middle holding the newest published value.
+ 
+    Publishing and picking up are a single atomic exchange of the middle slot, so
+    neither side ever waits for the other. If the producer publishes several times
+    before the consumer looks, the consumer only ever sees the newest one.
+ 
+    Only one thread may write and only one thread may read.
+*/
+template <typename ValueType>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+    
+    //==============================================================================
+    // Producer side
+    
+    // Slot the producer fills before calling publish(). Its content is whatever was
+    // published a few rounds ago, so it has to be completely overwritten.
+    ValueType& getWriteBuffer() noexcept { return buffers[(size_t) writeIndex]; }
+    
+    // Makes the write slot the newest value and hands the producer a free slot
+    void publish() noexcept
+    {
+        auto previous = middle.exchange(writeIndex | freshFlag, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+    
+    //==============================================================================
+    // Consumer side
+    
+    // Swaps in the newest published value, if there is one. Returns false if nothing
+    // was published since the last call, in which case the read slot is untouched.
+    bool pull() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & freshFlag) == 0)
+            return false;
+        
+        auto previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return true;
+    }
+    
+    const ValueType& getReadBuffer() const noexcept { return buffers[(size_t) readIndex]; }
+    
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshFlag = 4;
+    
+    std::array<ValueType, 3> buffers;
+    
+    int writeIndex = 0;      // Only touched by the producer
+    int readIndex = 1;       // Only touched by the consumer
+    std::atomic<int> middle {2};
+    
+    JUCE_DECLARE_NON_COPYABLE (TripleBuffer)
+};
@@ -0,0 +1,623 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    SimplyQueueBenchmark: times the DSP and the response curve, prints JSON.
+
+    Usage:
+        SimplyQueueBenchmark [--output results.json] [--seconds 0.5] [--repeats 5]
+
+    Every case is run --repeats times and the median is kept. processBlock is
+    reported in nanoseconds per sample (per channel sample, so layouts compare),
+    everything else in nanoseconds per call. Progress goes to stderr, the JSON to
+    stdout or to the --output file, to be kept and compared between releases.
+
+    Before anything is timed, every processing path is checked against the mono
+    chains: the exit code is 1, with no results, if one gives another output.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/PluginEditor.h"
+#include "../../../Source/CutFilterTable.h"
+#include "../../../Source/FrequencyResponse.h"
+
+namespace
+{
+//==============================================================================
+struct BenchmarkOptions
+{
+    // Audio processed by every processBlock case, per repeat
+    double secondsPerCase { 0.5 };
+    int repeats { 5 };
+    double sampleRate { 48000.0 };
+};
+
+// Written to after every timed call, so the optimiser can't drop the work
+volatile double sink = 0.0;
+
+// Runs the function 'repeats' times, returns the median run time in nanoseconds
+template<typename Function>
+double measureMedianNanoseconds(int repeats, Function&& run)
+{
+    std::vector<double> times;
+
+    for (int i = 0; i < repeats; ++i)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        run();
+        const auto end = juce::Time::getHighResolutionTicks();
+
+        times.push_back(juce::Time::highResolutionTicksToSeconds(end - start) * 1.0e9);
+    }
+
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+juce::var makeResult(const juce::String& name, std::initializer_list<std::pair<const char*, juce::var>> properties)
+{
+    auto* result = new juce::DynamicObject();
+    result->setProperty("name", name);
+
+    for (const auto& property : properties)
+        result->setProperty(property.first, property.second);
+
+    return juce::var(result);
+}
+
+//==============================================================================
+// The processBlock cases: one per block size, slope, layout, automation rate and processing path
+enum class Automation
+{
+    none,       // parameters never move
+    everyBlock, // one change before every processBlock
+    everySample // host splitting its buffer at every automation point: single sample processBlock calls
+};
+
+const char* getName(Automation automation)
+{
+    switch (automation)
+    {
+        case Automation::none:        return "static";
+        case Automation::everyBlock:  return "everyBlock";
+        case Automation::everySample: return "everySample";
+    }
+
+    return "";
+}
+
+const char* getName(SimplyQueueAudioProcessor::ProcessingPath path)
+{
+    switch (path)
+    {
+        case SimplyQueueAudioProcessor::ProcessingPath::monoChains:        return "monoChains";
+        case SimplyQueueAudioProcessor::ProcessingPath::simdLanes:         return "simdLanes";
+        case SimplyQueueAudioProcessor::ProcessingPath::pipelinedSections: return "pipelinedSections";
+    }
+
+    return "";
+}
+
+struct ProcessBlockCase
+{
+    int blockSize;
+    SlopeSettings slope;
+    int numChannels;
+    Automation automation;
+    SimplyQueueAudioProcessor::ProcessingPath path;
+    int numBands { 1 }; // Parametric bands switched on, 1 is the plugin before it had more than its peak
+};
+
+void setParameter(SimplyQueueAudioProcessor& processor, ParameterIndex index, float value)
+{
+    auto* parameter = processor.apvts.getParameter(getParameterId(index));
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+// Cuts inside the audible range and the first numBands parametric bands on, none of them neutral.
+// The others are off.
+void setUpBands(SimplyQueueAudioProcessor& processor, SlopeSettings slope, int numBands = 1)
+{
+    setParameter(processor, LowCutFreq, 80.0f);
+    setParameter(processor, HighCutFreq, 12000.0f);
+    setParameter(processor, LowCutSlope, (float) slope);
+    setParameter(processor, HighCutSlope, (float) slope);
+
+    for (int band = 0; band < maxNumBands; ++band)
+    {
+        const auto& indices = bandParameterTable[(size_t) band];
+
+        // Band 1 at 1kHz like before, the others an octave apart from 120Hz up
+        setParameter(processor, indices.freq, band == 0 ? 1000.0f : 60.0f * std::pow(2.0f, (float) band));
+        setParameter(processor, indices.gain, band % 2 == 0 ? 6.0f : -6.0f);
+        setParameter(processor, indices.quality, 1.0f);
+        setParameter(processor, indices.type, (float) Band_Peak);
+        setParameter(processor, indices.enabled, band < numBands ? 1.0f : 0.0f);
+    }
+}
+
+// Peak frequency swept at 1Hz, whatever the automation rate
+void automate(SimplyQueueAudioProcessor& processor, juce::int64 samplePosition, double sampleRate)
+{
+    const auto phase = juce::MathConstants<double>::twoPi * (double) samplePosition / sampleRate;
+    processor.apvts.getParameter(getParameterId(PeakFreq))->setValueNotifyingHost((float) (0.5 + 0.4 * std::sin(phase)));
+}
+
+double benchmarkProcessBlock(const ProcessBlockCase& benchmarkCase, const BenchmarkOptions& options)
+{
+    const auto blockSize = benchmarkCase.blockSize;
+    const auto numChannels = benchmarkCase.numChannels;
+
+    auto processor = std::make_unique<SimplyQueueAudioProcessor>();
+    processor->setPlayConfigDetails(numChannels, numChannels, options.sampleRate, blockSize);
+    processor->setProcessingPath(benchmarkCase.path);
+    setUpBands(*processor, benchmarkCase.slope, benchmarkCase.numBands);
+    processor->prepareToPlay(options.sampleRate, blockSize);
+
+    // Fresh noise in every block, like a host would give us. Filtering the same buffer
+    // over and over would fade it out until the silence detection skips everything.
+    juce::AudioBuffer<float> input(numChannels, blockSize), buffer(numChannels, blockSize);
+    juce::Random random(1234);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample(channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+    juce::MidiBuffer midi;
+    const auto numBlocks = juce::jmax(1, (int) (options.secondsPerCase * options.sampleRate) / blockSize);
+    juce::int64 samplePosition = 0;
+
+    auto processBlocks = [&]
+    {
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            buffer.makeCopyOf(input, true);
+
+            if (benchmarkCase.automation == Automation::everySample)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    automate(*processor, samplePosition++, options.sampleRate);
+
+                    juce::AudioBuffer<float> sample(buffer.getArrayOfWritePointers(), numChannels, i, 1);
+                    processor->processBlock(sample, midi);
+                }
+            }
+            else
+            {
+                if (benchmarkCase.automation == Automation::everyBlock)
+                    automate(*processor, samplePosition, options.sampleRate);
+
+                processor->processBlock(buffer, midi);
+                samplePosition += blockSize;
+            }
+        }
+
+        sink = sink + buffer.getSample(0, 0);
+    };
+
+    // One untimed run for the caches and the first designs
+    processBlocks();
+
+    const auto nanoseconds = measureMedianNanoseconds(options.repeats, processBlocks);
+    return nanoseconds / ((double) numBlocks * blockSize * numChannels);
+}
+
+void addProcessBlockResults(juce::Array<juce::var>& results, const BenchmarkOptions& options)
+{
+    const int blockSizes[] { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const int layouts[] { 1, 2, 6, 12 }; // mono, stereo, 5.1, 7.1.4
+    const SlopeSettings slopes[] { Slope_12, Slope_24, Slope_36, Slope_48 };
+    const SimplyQueueAudioProcessor::ProcessingPath paths[] { SimplyQueueAudioProcessor::ProcessingPath::monoChains,
+                                                               SimplyQueueAudioProcessor::ProcessingPath::simdLanes,
+                                                               SimplyQueueAudioProcessor::ProcessingPath::pipelinedSections };
+
+    // Single sample calls don't depend on the host buffer size, they only run at this one
+    constexpr int everySampleBlockSize = 512;
+
+    for (auto path : paths)
+        for (auto numChannels : layouts)
+            for (auto slope : slopes)
+                for (auto automation : { Automation::none, Automation::everyBlock, Automation::everySample })
+                    for (auto blockSize : blockSizes)
+                    {
+                        if (automation == Automation::everySample && blockSize != everySampleBlockSize)
+                            continue;
+
+                        const ProcessBlockCase benchmarkCase { blockSize, slope, numChannels, automation, path };
+                        const auto nsPerSample = benchmarkProcessBlock(benchmarkCase, options);
+
+                        std::cerr << "processBlock " << getName(path) << " " << numChannels << "ch "
+                                  << 12 * (slope + 1) << "dB/oct " << getName(automation) << " " << blockSize
+                                  << ": " << nsPerSample << " ns/sample" << std::endl;
+
+                        results.add(makeResult("processBlock", { { "blockSize", blockSize },
+                                                                 { "slopeDbPerOctave", 12 * (slope + 1) },
+                                                                 { "numChannels", numChannels },
+                                                                 { "automation", getName(automation) },
+                                                                 { "processingPath", getName(path) },
+                                                                 { "nsPerSample", nsPerSample } }));
+                    }
+}
+
+// What the parametric bands cost: the same stereo session with 0 to maxNumBands bands switched on.
+// The bands that are off must not cost anything.
+void addBandCountResults(juce::Array<juce::var>& results, const BenchmarkOptions& options)
+{
+    constexpr int blockSize = 512;
+    constexpr int numChannels = 2;
+
+    for (auto path : { SimplyQueueAudioProcessor::ProcessingPath::monoChains,
+                       SimplyQueueAudioProcessor::ProcessingPath::simdLanes,
+                       SimplyQueueAudioProcessor::ProcessingPath::pipelinedSections })
+        for (int numBands = 0; numBands <= maxNumBands; ++numBands)
+        {
+            const ProcessBlockCase benchmarkCase { blockSize, Slope_12, numChannels, Automation::none, path, numBands };
+            const auto nsPerSample = benchmarkProcessBlock(benchmarkCase, options);
+
+            std::cerr << "processBlock " << getName(path) << " " << numBands << " bands: "
+                      << nsPerSample << " ns/sample" << std::endl;
+
+            results.add(makeResult("processBlock bands", { { "blockSize", blockSize },
+                                                           { "numChannels", numChannels },
+                                                           { "numBands", numBands },
+                                                           { "processingPath", getName(path) },
+                                                           { "nsPerSample", nsPerSample } }));
+        }
+}
+
+//==============================================================================
+// How far a processing path is from the mono chains over the same noise, in dB relative to their output.
+// They run the same arithmetic, but where the compiler fuses multiplies and adds into FMAs (clang on
+// arm64) it does so differently in each path, and the low frequency sections amplify the difference:
+// about -65 dB in float. A missing, misplaced or misaligned section is far above the tolerance.
+constexpr double maxPathErrorFloat = -50.0;
+constexpr double maxPathErrorDouble = -150.0;
+
+template<typename SampleType>
+double measurePathError(SimplyQueueAudioProcessor::ProcessingPath path, int numChannels, const BenchmarkOptions& options)
+{
+    constexpr int blockSize = 512;
+    const auto numBlocks = juce::jmax(1, (int) options.sampleRate / blockSize);
+
+    auto prepare = [&](SimplyQueueAudioProcessor& processor, SimplyQueueAudioProcessor::ProcessingPath processingPath)
+    {
+        processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision
+                                                                            : juce::AudioProcessor::singlePrecision);
+        processor.setPlayConfigDetails(numChannels, numChannels, options.sampleRate, blockSize);
+        processor.setProcessingPath(processingPath);
+        setUpBands(processor, Slope_48, maxNumBands);
+        processor.prepareToPlay(options.sampleRate, blockSize);
+    };
+
+    SimplyQueueAudioProcessor reference, tested;
+    prepare(reference, SimplyQueueAudioProcessor::ProcessingPath::monoChains);
+    prepare(tested, path);
+
+    juce::AudioBuffer<SampleType> referenceBuffer(numChannels, blockSize), testedBuffer(numChannels, blockSize);
+    juce::Random random(1234);
+    juce::MidiBuffer midi;
+    double errorEnergy = 0.0, outputEnergy = 0.0;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < blockSize; ++i)
+                referenceBuffer.setSample(channel, i, (SampleType) (random.nextFloat() * 2.0f - 1.0f));
+
+        testedBuffer.makeCopyOf(referenceBuffer, true);
+
+        reference.processBlock(referenceBuffer, midi);
+        tested.processBlock(testedBuffer, midi);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const auto expected = (double) referenceBuffer.getSample(channel, i);
+                const auto error = (double) testedBuffer.getSample(channel, i) - expected;
+
+                errorEnergy += error * error;
+                outputEnergy += expected * expected;
+            }
+        }
+    }
+
+    // Bit for bit the same
+    if (errorEnergy == 0.0)
+        return -std::numeric_limits<double>::infinity();
+
+    return 10.0 * std::log10(errorEnergy / outputEnergy);
+}
+
+// A path that doesn't give the output of the mono chains has no timing worth keeping
+bool checkProcessingPaths(const BenchmarkOptions& options)
+{
+    auto allAgree = true;
+
+    for (auto path : { SimplyQueueAudioProcessor::ProcessingPath::simdLanes,
+                       SimplyQueueAudioProcessor::ProcessingPath::pipelinedSections })
+        for (auto numChannels : { 1, 2, 6 })
+            for (auto doublePrecision : { false, true })
+            {
+                const auto error = doublePrecision ? measurePathError<double>(path, numChannels, options)
+                                                   : measurePathError<float>(path, numChannels, options);
+                const auto agrees = error <= (doublePrecision ? maxPathErrorDouble : maxPathErrorFloat);
+
+                std::cerr << "path check " << getName(path) << " " << numChannels << "ch "
+                          << (doublePrecision ? "double" : "float") << ": " << error << " dB"
+                          << (agrees ? "" : " FAILED") << std::endl;
+
+                allAgree = allAgree && agrees;
+            }
+
+    return allAgree;
+}
+
+//==============================================================================
+// The coefficient design on its own, with a new frequency for every call
+template<typename DesignFunction>
+double benchmarkDesign(const BenchmarkOptions& options, DesignFunction&& design)
+{
+    constexpr int numCalls = 10000;
+
+    ChainSettings settings;
+    settings.bands[0].enabled = true;
+    settings.bands[0].gainInDecibels = 6.0f;
+
+    const auto nanoseconds = measureMedianNanoseconds(options.repeats, [&]
+    {
+        for (int i = 0; i < numCalls; ++i)
+        {
+            // Log sweep over 20Hz - 20kHz
+            const auto frequency = 20.0f * std::pow(1000.0f, (float) i / numCalls);
+            settings.lowCutFreq = settings.highCutFreq = settings.bands[0].freq = frequency;
+
+            sink = sink + design(settings);
+        }
+    });
+
+    return nanoseconds / numCalls;
+}
+
+void addDesignResults(juce::Array<juce::var>& results, const BenchmarkOptions& options)
+{
+    const auto sampleRate = options.sampleRate;
+
+    auto addResult = [&](const juce::String& name, int slope, double nsPerCall)
+    {
+        std::cerr << name << " " << 12 * (slope + 1) << "dB/oct: " << nsPerCall << " ns/call" << std::endl;
+        results.add(makeResult(name, { { "slopeDbPerOctave", 12 * (slope + 1) }, { "nsPerCall", nsPerCall } }));
+    };
+
+    const auto bandTypeNames = getChoiceNames(ChoiceList::BandTypes);
+
+    for (auto type : { Band_Peak, Band_LowShelf, Band_HighShelf, Band_Notch })
+    {
+        const auto bandNs = benchmarkDesign(options, [&](ChainSettings& settings)
+        {
+            settings.bands[0].type = type;
+            return makeBandCoefficients(settings.bands[0], sampleRate).b0;
+        });
+
+        std::cerr << "makeBandCoefficients " << bandTypeNames[type] << ": " << bandNs << " ns/call" << std::endl;
+        results.add(makeResult("makeBandCoefficients", { { "type", bandTypeNames[type] }, { "nsPerCall", bandNs } }));
+    }
+
+    // The table the designer looks the cuts up in, instead of designing them
+    const CutFilterTable table(sampleRate);
+
+    for (auto slope : { Slope_12, Slope_24, Slope_36, Slope_48 })
+    {
+        addResult("makeLowCutCoefficients", slope, benchmarkDesign(options, [&](ChainSettings& settings)
+        {
+            settings.lowCutSlope = slope;
+            return makeLowCutCoefficients(settings, sampleRate)[0].b0;
+        }));
+
+        addResult("makeHighCutCoefficients", slope, benchmarkDesign(options, [&](ChainSettings& settings)
+        {
+            settings.highCutSlope = slope;
+            return makeHighCutCoefficients(settings, sampleRate)[0].b0;
+        }));
+
+        addResult("makeChainCoefficients", slope, benchmarkDesign(options, [&](ChainSettings& settings)
+        {
+            settings.lowCutSlope = settings.highCutSlope = slope;
+            return makeChainCoefficients(settings, sampleRate).bands[0].b0;
+        }));
+
+        addResult("CutFilterTable::lookUp", slope, benchmarkDesign(options, [&](ChainSettings& settings)
+        {
+            CutCoefficients sections;
+            table.lookUp(CutFilterTable::CutType::lowCut, settings.lowCutFreq, slope, sections);
+            return sections[0].b0;
+        }));
+    }
+}
+
+//==============================================================================
+// The whole chain's response over a log sweep: one point at a time, then in one batch
+void addFrequencyResponseResults(juce::Array<juce::var>& results, const BenchmarkOptions& options)
+{
+    constexpr int numCalls = 100;
+
+    ChainSettings settings;
+    settings.bands[0].enabled = true;
+    settings.bands[0].freq = 1000.0f;
+    settings.bands[0].gainInDecibels = 6.0f;
+    settings.lowCutFreq = 80.0f;
+    settings.highCutFreq = 12000.0f;
+    settings.lowCutSlope = settings.highCutSlope = Slope_48;
+
+    const auto chainCoefficients = makeChainCoefficients(settings, options.sampleRate);
+
+    for (auto numPoints : { 256, 1024, 4096 })
+    {
+        std::vector<double> frequencies((size_t) numPoints), magnitudes((size_t) numPoints);
+        std::vector<double> phases((size_t) numPoints), groupDelays((size_t) numPoints);
+
+        for (int i = 0; i < numPoints; ++i)
+            frequencies[(size_t) i] = juce::mapToLog10((double) i / numPoints, 20.0, 20000.0);
+
+        auto addResult = [&](const juce::String& name, double nanoseconds)
+        {
+            const auto nsPerPoint = nanoseconds / (numCalls * numPoints);
+            std::cerr << name << " " << numPoints << " points: " << nsPerPoint << " ns/point" << std::endl;
+            results.add(makeResult(name, { { "numPoints", numPoints }, { "nsPerPoint", nsPerPoint } }));
+        };
+
+        addResult("getMagnitudeForFrequency", measureMedianNanoseconds(options.repeats, [&]
+        {
+            for (int call = 0; call < numCalls; ++call)
+                for (int i = 0; i < numPoints; ++i)
+                    magnitudes[(size_t) i] = getMagnitudeForFrequency(chainCoefficients, frequencies[(size_t) i], options.sampleRate);
+
+            sink = sink + magnitudes[0];
+        }));
+
+        FrequencyResponseOutput magnitudeOnly;
+        magnitudeOnly.magnitudes = magnitudes.data();
+
+        addResult("computeFrequencyResponse magnitude", measureMedianNanoseconds(options.repeats, [&]
+        {
+            for (int call = 0; call < numCalls; ++call)
+                computeFrequencyResponse(chainCoefficients, frequencies.data(), numPoints, options.sampleRate, magnitudeOnly);
+
+            sink = sink + magnitudes[0];
+        }));
+
+        const FrequencyResponseOutput everything { magnitudes.data(), phases.data(), groupDelays.data() };
+
+        addResult("computeFrequencyResponse magnitude+phase+groupDelay", measureMedianNanoseconds(options.repeats, [&]
+        {
+            for (int call = 0; call < numCalls; ++call)
+                computeFrequencyResponse(chainCoefficients, frequencies.data(), numPoints, options.sampleRate, everything);
+
+            sink = sink + groupDelays[0];
+        }));
+    }
+}
+
+//==============================================================================
+// ResponseCurveComponent::paint at its size in the editor, into an image
+void addResponseCurveResults(juce::Array<juce::var>& results, const BenchmarkOptions& options)
+{
+    constexpr int numPaints = 200;
+
+    SimplyQueueAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, options.sampleRate, 512);
+    setUpBands(processor, Slope_48);
+    processor.prepareToPlay(options.sampleRate, 512);
+
+    ResponseCurveComponent responseCurve(processor);
+    responseCurve.setSize(600, 132);
+
+    // Never on screen, so nothing notifies it: pick the prepared design up for it
+    processor.pullCoefficientSnapshot();
+
+    juce::Image image(juce::Image::RGB, responseCurve.getWidth(), responseCurve.getHeight(), true);
+
+    auto addResult = [&](const juce::String& name, double nanoseconds)
+    {
+        const auto nsPerCall = nanoseconds / numPaints;
+        std::cerr << name << ": " << nsPerCall << " ns/call" << std::endl;
+        results.add(makeResult(name, { { "width", responseCurve.getWidth() },
+                                       { "height", responseCurve.getHeight() },
+                                       { "nsPerCall", nsPerCall } }));
+    };
+
+    // Only the drawing, the curve doesn't change
+    addResult("ResponseCurveComponent::paint", measureMedianNanoseconds(options.repeats, [&]
+    {
+        for (int i = 0; i < numPaints; ++i)
+        {
+            juce::Graphics g(image);
+            responseCurve.paint(g);
+        }
+    }));
+
+    // What a moving knob costs the editor: the curve of a new coefficient snapshot is computed and
+    // drawn again (the design itself happens on the designer's thread). resized() forces it.
+    addResult("ResponseCurveComponent::redraw", measureMedianNanoseconds(options.repeats, [&]
+    {
+        for (int i = 0; i < numPaints; ++i)
+        {
+            responseCurve.resized();
+
+            juce::Graphics g(image);
+            responseCurve.paint(g);
+        }
+    }));
+}
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // Components and parameters need the message manager, nothing is ever shown
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: SimplyQueueBenchmark [--output results.json] [--seconds 0.5] [--repeats 5]" << std::endl;
+        return 0;
+    }
+
+    BenchmarkOptions options;
+
+    if (args.containsOption("--seconds"))
+        options.secondsPerCase = juce::jmax(0.001, args.getValueForOption("--seconds").getDoubleValue());
+
+    if (args.containsOption("--repeats"))
+        options.repeats = juce::jmax(1, args.getValueForOption("--repeats").getIntValue());
+
+    if (! checkProcessingPaths(options))
+    {
+        std::cerr << "FAILED: the processing paths don't give the same output" << std::endl;
+        return 1;
+    }
+
+    juce::Array<juce::var> results;
+    addDesignResults(results, options);
+    addFrequencyResponseResults(results, options);
+    addResponseCurveResults(results, options);
+    addProcessBlockResults(results, options);
+    addBandCountResults(results, options);
+
+    // Enough about the machine and the run to know which results can be compared
+    auto* report = new juce::DynamicObject();
+    report->setProperty("plugin", "SimplyQueue");
+    report->setProperty("version", ProjectInfo::versionString);
+    report->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    report->setProperty("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    report->setProperty("sampleRate", options.sampleRate);
+    report->setProperty("secondsPerCase", options.secondsPerCase);
+    report->setProperty("repeats", options.repeats);
+    report->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (args.containsOption("--output"))
+    {
+        const auto outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+        if (! outputFile.replaceWithText(json))
+        {
+            std::cerr << "Can't write " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    SimplyQueueRender: runs audio files through the plugin's DSP without a host.
+
+    Usage:
+        SimplyQueueRender --state <preset> --output <folder> [--block-size 512]
+                          [--threads N] [--trace trace.json] [--verify] <file> [<file> ...]
+
+    The preset is the blob written by getStateInformation() (what a host saves in
+    its session). Every file gets its own processor instance, the files are
+    shared out over a thread pool so a batch uses every core. --verify renders
+    every file twice and fails if the two outputs are not identical.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/Tracer.h"
+
+namespace
+{
+//==============================================================================
+struct RenderSettings
+{
+    juce::MemoryBlock state;
+    juce::File outputFolder;
+
+    // Size of the processBlock calls. The output is bit identical to the plugin
+    // in a host running at this buffer size.
+    int blockSize { 512 };
+
+    // Disk reads and writes are done this many blocks at a time
+    int blocksPerRead { 64 };
+
+    // Every file is rendered a second time and compared with the first output
+    bool verify { false };
+};
+
+struct RenderResult
+{
+    juce::String error;
+    double audioSeconds { 0.0 };
+    double renderSeconds { 0.0 };
+
+    bool succeeded() const { return error.isEmpty(); }
+};
+
+juce::String formatRealtimeMultiple(double audioSeconds, double renderSeconds)
+{
+    if (renderSeconds <= 0.0)
+        return "-";
+
+    return juce::String(audioSeconds / renderSeconds, 1) + "x realtime";
+}
+
+//==============================================================================
+// Picks the bit depth of the input if the output format can write it, the deepest one it has otherwise
+int chooseBitDepth(juce::AudioFormat& format, int inputBitDepth)
+{
+    const auto depths = format.getPossibleBitDepths();
+
+    if (depths.contains(inputBitDepth) || depths.isEmpty())
+        return inputBitDepth;
+
+    return depths.getLast();
+}
+
+RenderResult renderFile(const juce::File& input, const juce::File& outputFile, const RenderSettings& settings,
+                        juce::AudioFormatManager& formats)
+{
+    RenderResult result;
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+
+    if (reader == nullptr)
+    {
+        result.error = "can't read this file";
+        return result;
+    }
+
+    const auto numChannels = (int) reader->numChannels;
+    const auto sampleRate = reader->sampleRate;
+
+    if (numChannels < 1 || numChannels > (int) maxNumChannels)
+    {
+        result.error = juce::String(numChannels) + " channels, the plugin takes 1 to " + juce::String((int) maxNumChannels);
+        return result;
+    }
+
+    // Same order as a host: bus layout, saved state, then prepare. prepareToPlay
+    // designs every band straight away so the first block already has the right filters.
+    // On the heap, the chains are too big for a pool thread's stack
+    auto processor = std::make_unique<SimplyQueueAudioProcessor>();
+    processor->setPlayConfigDetails(numChannels, numChannels, sampleRate, settings.blockSize);
+
+    if (processor->getTotalNumOutputChannels() != numChannels)
+    {
+        result.error = "the processor refused a " + juce::String(numChannels) + " channel layout";
+        return result;
+    }
+
+    processor->setNonRealtime(true);
+    processor->setStateInformation(settings.state.getData(), (int) settings.state.getSize());
+    processor->prepareToPlay(sampleRate, settings.blockSize);
+
+    // Output in the same format and bit depth as the input, never on top of it
+    auto* format = formats.findFormatForFileExtension(input.getFileExtension());
+
+    if (format == nullptr || outputFile == input)
+    {
+        result.error = "no output file for this input";
+        return result;
+    }
+
+    outputFile.deleteFile();
+    auto stream = std::make_unique<juce::FileOutputStream>(outputFile);
+
+    if (! stream->openedOk())
+    {
+        result.error = "can't write " + outputFile.getFullPathName();
+        return result;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+                                                                            (unsigned int) numChannels,
+                                                                            chooseBitDepth(*format, (int) reader->bitsPerSample),
+                                                                            reader->metadataValues, 0));
+
+    if (writer == nullptr)
+    {
+        result.error = "the " + format->getFormatName() + " writer refused this format";
+        return result;
+    }
+
+    // The writer owns the stream now
+    stream.release();
+
+    // One large buffer for the disk, processed in blockSize slices that point into it
+    const auto readSize = settings.blockSize * settings.blocksPerRead;
+    juce::AudioBuffer<float> buffer(numChannels, readSize);
+    juce::MidiBuffer midi;
+
+    for (juce::int64 position = 0; position < reader->lengthInSamples; position += readSize)
+    {
+        const auto numSamples = (int) juce::jmin((juce::int64) readSize, reader->lengthInSamples - position);
+        reader->read(&buffer, 0, numSamples, position, true, true);
+
+        for (int offset = 0; offset < numSamples; offset += settings.blockSize)
+        {
+            // No copy: the block refers to the samples of the big buffer
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, offset,
+                                           juce::jmin(settings.blockSize, numSamples - offset));
+            processor->processBlock(block, midi);
+        }
+
+        if (! writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+        {
+            result.error = "writing " + outputFile.getFullPathName() + " failed";
+            return result;
+        }
+    }
+
+    processor->releaseResources();
+
+    result.audioSeconds = (double) reader->lengthInSamples / sampleRate;
+    result.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    return result;
+}
+
+// Renders the file again next to its output and compares the two, byte for byte: the same
+// input and preset must always give the same file
+RenderResult verifyRender(const juce::File& input, const juce::File& outputFile, const RenderSettings& settings,
+                          juce::AudioFormatManager& formats)
+{
+    const auto secondFile = outputFile.getSiblingFile(outputFile.getFileNameWithoutExtension() + ".verify"
+                                                      + outputFile.getFileExtension());
+
+    auto result = renderFile(input, secondFile, settings, formats);
+
+    if (result.succeeded() && ! secondFile.hasIdenticalContentTo(outputFile))
+        result.error = "two renders of the same file differ";
+
+    secondFile.deleteFile();
+    return result;
+}
+
+//==============================================================================
+void printUsage()
+{
+    std::cout << "Usage: SimplyQueueRender --state <preset> --output <folder> [--block-size 512] [--threads N] [--trace trace.json] [--verify] <file> [<file> ...]" << std::endl
+              << "  --state       plugin state saved by getStateInformation()" << std::endl
+              << "  --output      folder for the rendered files (same names and format as the inputs)" << std::endl
+              << "  --block-size  samples per processBlock call, the output matches a host at this size" << std::endl
+              << "  --threads     files rendered in parallel, all cores by default" << std::endl
+              << "  --trace       saves the processBlock and design events as a Chrome / Perfetto trace" << std::endl
+              << "  --verify      renders every file twice, fails if the outputs differ" << std::endl;
+}
+
+int fail(const juce::String& message)
+{
+    std::cerr << message << std::endl;
+    printUsage();
+    return 1;
+}
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processor and its parameters need the message manager to exist, nothing is ever shown
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    RenderSettings settings;
+
+    const auto stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--state"));
+
+    if (! stateFile.existsAsFile() || ! stateFile.loadFileAsData(settings.state))
+        return fail("Can't read the state file: " + stateFile.getFullPathName());
+
+    settings.outputFolder = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+    if (! args.containsOption("--output") || ! settings.outputFolder.createDirectory())
+        return fail("Can't use the output folder: " + settings.outputFolder.getFullPathName());
+
+    settings.verify = args.containsOption("--verify");
+
+    if (args.containsOption("--block-size"))
+        settings.blockSize = args.getValueForOption("--block-size").getIntValue();
+
+    if (settings.blockSize < 1)
+        return fail("The block size must be at least 1 sample");
+
+    auto numThreads = juce::SystemStats::getNumCpus();
+
+    if (args.containsOption("--threads"))
+        numThreads = juce::jmax(1, args.getValueForOption("--threads").getIntValue());
+
+    // Everything that isn't an option or an option's value is a file to render
+    juce::Array<juce::File> inputs;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        if (args[i].isOption())
+        {
+            // "--option value" takes the next argument too, "--option=value" and flags don't
+            if (! args[i].text.contains("=") && args[i] != "--verify")
+                ++i;
+
+            continue;
+        }
+
+        inputs.add(args[i].resolveAsFile());
+    }
+
+    if (inputs.isEmpty())
+        return fail("No files to render");
+
+    // Shared by every job, it is only read from once the formats are registered
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+   #if SIMPLYQUEUE_TRACING
+    if (args.containsOption("--trace"))
+        Tracer::getInstance().setEnabled(true);
+   #endif
+
+    std::vector<RenderResult> results((size_t) inputs.size());
+    juce::CriticalSection printLock;
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    {
+        juce::ThreadPool pool(juce::jmin(numThreads, inputs.size()));
+
+        for (int i = 0; i < inputs.size(); ++i)
+        {
+            pool.addJob([&, i]
+            {
+                auto& result = results[(size_t) i];
+                const auto outputFile = settings.outputFolder.getChildFile(inputs[i].getFileName());
+                result = renderFile(inputs[i], outputFile, settings, formats);
+
+                if (result.succeeded() && settings.verify)
+                    result.error = verifyRender(inputs[i], outputFile, settings, formats).error;
+
+                const juce::ScopedLock lock(printLock);
+
+                if (result.succeeded())
+                    std::cout << inputs[i].getFileName() << ": " << juce::String(result.audioSeconds, 1) << " s in "
+                              << juce::String(result.renderSeconds, 2) << " s, "
+                              << formatRealtimeMultiple(result.audioSeconds, result.renderSeconds) << std::endl;
+                else
+                    std::cerr << inputs[i].getFileName() << ": " << result.error << std::endl;
+            });
+        }
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(10);
+    }
+
+    const auto totalSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+   #if SIMPLYQUEUE_TRACING
+    if (args.containsOption("--trace"))
+    {
+        Tracer::getInstance().setEnabled(false);
+
+        const auto traceFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--trace"));
+
+        if (! Tracer::getInstance().writeChromeJson(traceFile))
+            std::cerr << "Can't write the trace to " << traceFile.getFullPathName() << std::endl;
+    }
+   #endif
+
+    double totalAudioSeconds = 0.0;
+    int numFailed = 0;
+
+    for (const auto& result : results)
+    {
+        totalAudioSeconds += result.audioSeconds;
+        numFailed += result.succeeded() ? 0 : 1;
+    }
+
+    std::cout << inputs.size() - numFailed << " of " << inputs.size() << " files, "
+              << juce::String(totalAudioSeconds, 1) << " s of audio in " << juce::String(totalSeconds, 2) << " s on "
+              << numThreads << " threads: " << formatRealtimeMultiple(totalAudioSeconds, totalSeconds) << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,374 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    SimplyQueueRealtimeCheck: fails if processBlock allocates or locks a mutex.
+
+    Usage:
+        SimplyQueueRealtimeCheck [--channels 2] [--block-size 256]
+
+    Built with SIMPLYQUEUE_REALTIME_GUARD=1: processBlock marks the audio thread as
+    realtime, and the hooks below report every operator new / delete and every
+    pthread mutex lock done from it, with a stack trace. The processor is driven
+    through automation, state loads, path and mode switches, silence and sample
+    rate changes, in single and double precision. The exit code is 1 if anything
+    was reported.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/RealtimeGuard.h"
+
+#if ! SIMPLYQUEUE_REALTIME_GUARD
+ #error "The realtime check only makes sense with SIMPLYQUEUE_REALTIME_GUARD=1"
+#endif
+
+//==============================================================================
+// Hooks: every allocation of the program goes through these. Outside a realtime scope
+// they only cost the check of a thread_local.
+//==============================================================================
+namespace
+{
+void* allocate(std::size_t size)
+{
+    if (RealtimeGuard::isInRealtimeScope())
+        RealtimeGuard::reportViolation("operator new");
+
+    if (auto* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    if (RealtimeGuard::isInRealtimeScope())
+        RealtimeGuard::reportViolation("operator new (aligned)");
+
+    // aligned_alloc wants a size that is a multiple of the alignment
+    const auto align = (std::size_t) alignment;
+
+    if (auto* memory = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void deallocate(void* memory) noexcept
+{
+    if (memory != nullptr && RealtimeGuard::isInRealtimeScope())
+        RealtimeGuard::reportViolation("operator delete");
+
+    std::free(memory);
+}
+}
+
+void* operator new  (std::size_t size)                                           { return allocate(size); }
+void* operator new[](std::size_t size)                                           { return allocate(size); }
+void* operator new  (std::size_t size, const std::nothrow_t&) noexcept           { try { return allocate(size); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept           { try { return allocate(size); } catch (...) { return nullptr; } }
+void* operator new  (std::size_t size, std::align_val_t alignment)               { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment)               { return allocateAligned(size, alignment); }
+
+void operator delete  (void* memory) noexcept                                    { deallocate(memory); }
+void operator delete[](void* memory) noexcept                                    { deallocate(memory); }
+void operator delete  (void* memory, std::size_t) noexcept                       { deallocate(memory); }
+void operator delete[](void* memory, std::size_t) noexcept                       { deallocate(memory); }
+void operator delete  (void* memory, const std::nothrow_t&) noexcept             { deallocate(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept             { deallocate(memory); }
+void operator delete  (void* memory, std::align_val_t) noexcept                  { deallocate(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept                  { deallocate(memory); }
+void operator delete  (void* memory, std::size_t, std::align_val_t) noexcept     { deallocate(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept     { deallocate(memory); }
+
+// juce::CriticalSection, std::mutex and friends all end up here. The real function is found
+// with dlsym on first use: a function-local static would itself lock a mutex to initialise.
+using MutexLockFunction = int (*)(pthread_mutex_t*);
+static MutexLockFunction realMutexLock = nullptr;
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    if (realMutexLock == nullptr)
+        realMutexLock = (MutexLockFunction) dlsym(RTLD_NEXT, "pthread_mutex_lock");
+
+    if (RealtimeGuard::isInRealtimeScope())
+        RealtimeGuard::reportViolation("pthread_mutex_lock");
+
+    return realMutexLock(mutex);
+}
+
+//==============================================================================
+namespace
+{
+// Stands in for the plugin wrapper, which a host always has registered: without a listener,
+// updateHostDisplay() and the parameter notifications never take the processor's listener lock
+struct HostListener : juce::AudioProcessorListener
+{
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int, float) override {}
+    void audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails&) override {}
+};
+
+// One processor driven like a host would: parameters and state are changed between the
+// blocks, the blocks come at varying sizes, and the design thread gets time to run.
+class RealtimeCheck
+{
+public:
+    RealtimeCheck(int channels, int maxBlockSize) : numChannels(channels), blockSize(maxBlockSize)
+    {
+        floatBuffer.setSize(numChannels, blockSize);
+        doubleBuffer.setSize(numChannels, blockSize);
+
+        processor.addListener(&hostListener);
+    }
+
+    ~RealtimeCheck()
+    {
+        processor.removeListener(&hostListener);
+    }
+
+    // Sample rate and precision changes go through releaseResources, like in a host
+    void prepare(double sampleRate, bool doublePrecision)
+    {
+        processor.releaseResources();
+        processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                         : juce::AudioProcessor::singlePrecision);
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+
+    // Runs a scenario, returns how many violations it caused
+    template<typename Scenario>
+    int run(const juce::String& name, Scenario&& scenario)
+    {
+        RealtimeGuard::clearViolations();
+        scenario();
+
+        const auto violations = RealtimeGuard::getViolations();
+        std::cout << "  " << name << ": " << (violations.empty() ? "ok" : juce::String((int) violations.size()) + " violations") << std::endl;
+
+        for (const auto& violation : violations)
+            std::cout << "    " << violation.what << " in processBlock" << std::endl << violation.stackTrace << std::endl;
+
+        return (int) violations.size();
+    }
+
+    // Noise, or silence, in blocks of random sizes. 'beforeBlock' is called with the block number before every block.
+    template<typename BeforeBlock>
+    void processBlocks(int numBlocks, bool silent, BeforeBlock&& beforeBlock)
+    {
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            beforeBlock(block);
+
+            const auto numSamples = 1 + random.nextInt(blockSize);
+
+            if (processor.isUsingDoublePrecision())
+                processBlock(doubleBuffer, numSamples, silent);
+            else
+                processBlock(floatBuffer, numSamples, silent);
+
+            // Leave the designer some time, the host would call us at the pace of the audio
+            if (block % 4 == 0)
+                juce::Thread::sleep(1);
+        }
+    }
+
+    void processBlocks(int numBlocks, bool silent = false)
+    {
+        processBlocks(numBlocks, silent, [](int) {});
+    }
+
+    void randomiseParameters(SimplyQueueAudioProcessor& target)
+    {
+        for (auto* parameter : target.getParameters())
+            parameter->setValueNotifyingHost(random.nextFloat());
+    }
+
+    HostListener hostListener;
+    SimplyQueueAudioProcessor processor;
+    juce::Random random { 42 };
+
+private:
+    template<typename SampleType>
+    void processBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples, bool silent)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* samples = buffer.getWritePointer(channel);
+
+            for (int i = 0; i < numSamples; ++i)
+                samples[i] = silent ? SampleType(0) : (SampleType) (random.nextFloat() * 2.0f - 1.0f);
+        }
+
+        // Built before the realtime scope opens, the host owns its buffers
+        juce::AudioBuffer<SampleType> block(buffer.getArrayOfWritePointers(), numChannels, 0, numSamples);
+        processor.processBlock(block, midi);
+    }
+
+    const int numChannels, blockSize;
+    juce::AudioBuffer<float> floatBuffer;
+    juce::AudioBuffer<double> doubleBuffer;
+    juce::MidiBuffer midi;
+};
+
+int runScenarios(RealtimeCheck& check)
+{
+    auto& processor = check.processor;
+    auto numViolations = 0;
+
+    numViolations += check.run("static parameters", [&] { check.processBlocks(64); });
+
+    // Every parameter on its own, from one end of its range to the other
+    numViolations += check.run("automation sweeps", [&]
+    {
+        for (auto* parameter : processor.getParameters())
+        {
+            check.processBlocks(64, false, [&](int block)
+            {
+                parameter->setValueNotifyingHost((float) block / 63.0f);
+            });
+        }
+    });
+
+    numViolations += check.run("random jumps", [&]
+    {
+        check.processBlocks(128, false, [&](int) { check.randomiseParameters(processor); });
+    });
+
+    // Presets recalled while playing, from another instance
+    numViolations += check.run("state loads", [&]
+    {
+        SimplyQueueAudioProcessor other;
+
+        check.processBlocks(64, false, [&](int block)
+        {
+            if (block % 8 != 0)
+                return;
+
+            check.randomiseParameters(other);
+
+            juce::MemoryBlock state;
+            other.getStateInformation(state);
+            processor.setStateInformation(state.getData(), (int) state.getSize());
+        });
+    });
+
+    numViolations += check.run("processing path switches", [&]
+    {
+        const SimplyQueueAudioProcessor::ProcessingPath paths[] { SimplyQueueAudioProcessor::ProcessingPath::simdLanes,
+                                                                   SimplyQueueAudioProcessor::ProcessingPath::pipelinedSections,
+                                                                   SimplyQueueAudioProcessor::ProcessingPath::monoChains };
+
+        check.processBlocks(96, false, [&](int block)
+        {
+            processor.setProcessingPath(paths[(block / 8) % 3]);
+        });
+
+        processor.setProcessingPath(SimplyQueueAudioProcessor::ProcessingPath::monoChains);
+    });
+
+    numViolations += check.run("neutral bands", [&]
+    {
+        const auto threshold = processor.getNeutralBandThreshold();
+
+        check.processBlocks(64, false, [&](int block)
+        {
+            processor.setNeutralBandThreshold(block % 16 < 8 ? 6.0f : 0.0f);
+        });
+
+        processor.setNeutralBandThreshold(threshold);
+    });
+
+    // Long enough for the tail to run out and the chains to go idle, then signal again
+    numViolations += check.run("silence", [&]
+    {
+        check.processBlocks(4096, true);
+        check.processBlocks(16);
+    });
+
+    numViolations += check.run("linear phase", [&]
+    {
+        auto* linearPhase = processor.apvts.getParameter(getParameterId(LinearPhase));
+        auto* firLength = processor.apvts.getParameter(getParameterId(FirLength));
+
+        check.processBlocks(128, false, [&](int block)
+        {
+            if (block % 32 == 0)
+                linearPhase->setValueNotifyingHost(block % 64 == 0 ? 1.0f : 0.0f);
+
+            if (block % 16 == 8)
+                firLength->setValueNotifyingHost(check.random.nextFloat());
+        });
+
+        linearPhase->setValueNotifyingHost(0.0f);
+    });
+
+    // What the editor switches on: the load meter timing and the spectrum analyser copying every block
+    numViolations += check.run("editor open", [&]
+    {
+       #if SIMPLYQUEUE_LOAD_METER
+        processor.getLoadMeter().setReading(true);
+       #endif
+       #if SIMPLYQUEUE_SPECTRUM_ANALYZER
+        processor.getSpectrumAnalyzer().setActive(true);
+       #endif
+
+        check.processBlocks(128, false, [&](int) { check.randomiseParameters(processor); });
+
+       #if SIMPLYQUEUE_SPECTRUM_ANALYZER
+        processor.getSpectrumAnalyzer().setActive(false);
+       #endif
+       #if SIMPLYQUEUE_LOAD_METER
+        processor.getLoadMeter().setReading(false);
+       #endif
+    });
+
+    return numViolations;
+}
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processor and its parameters need the message manager, nothing is ever shown
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList args(argc, argv);
+
+    const auto numChannels = args.containsOption("--channels") ? args.getValueForOption("--channels").getIntValue() : 2;
+    const auto blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 256;
+
+    if (numChannels < 1 || numChannels > (int) maxNumChannels || blockSize < 1)
+    {
+        std::cerr << "Usage: SimplyQueueRealtimeCheck [--channels 1-" << (int) maxNumChannels << "] [--block-size 256]" << std::endl;
+        return 1;
+    }
+
+    RealtimeCheck check(numChannels, blockSize);
+    auto numViolations = 0;
+
+    // One processor for the whole run: every change of sample rate and precision re-prepares it
+    for (auto doublePrecision : { false, true })
+    {
+        for (auto sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+        {
+            std::cout << juce::String(sampleRate, 0) << " Hz, " << (doublePrecision ? "double" : "float") << std::endl;
+
+            check.prepare(sampleRate, doublePrecision);
+            numViolations += runScenarios(check);
+        }
+    }
+
+    if (numViolations > 0)
+    {
+        std::cout << "FAILED: " << numViolations << " allocations or locks in processBlock" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Passed: no allocation or lock in processBlock" << std::endl;
+    return 0;
+}